@@ -0,0 +1,83 @@
+#include "./compact_view.h"
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace {
+	struct predicate_registry {
+		std::mutex mutex;
+		std::atomic<std::size_t> count{0};
+		std::array<std::unique_ptr<const fsv::filter>, fsv::max_registered_predicates> slots;
+	};
+	auto registry() -> predicate_registry& {
+		// Never destroyed, so ids stay valid during static destruction. Slot 0 is not
+		// filtered_string_view::default_predicate, which may not be constructed yet if this runs during
+		// static initialisation.
+		static auto* instance = [] {
+			auto* r = new predicate_registry();
+			r->slots[0] = std::make_unique<const fsv::filter>([](const char&) { return true; });
+			r->count.store(1, std::memory_order_release);
+			return r;
+		}();
+		return *instance;
+	}
+} // namespace
+
+auto fsv::register_predicate(filter predicate) -> predicate_id {
+	auto& r = registry();
+	auto lock = std::lock_guard(r.mutex);
+	auto id = r.count.load(std::memory_order_relaxed);
+	if (id == max_registered_predicates) {
+		throw std::length_error("register_predicate: predicate registry is full");
+	}
+	r.slots[id] = std::make_unique<const filter>(std::move(predicate));
+	r.count.store(id + 1, std::memory_order_release);
+	return static_cast<predicate_id>(id);
+}
+auto fsv::registered_predicate(predicate_id id) -> const filter& {
+	auto& r = registry();
+	if (id >= r.count.load(std::memory_order_acquire)) {
+		throw std::out_of_range("registered_predicate(" + std::to_string(id) + "): no such predicate");
+	}
+	return *r.slots[id];
+}
+
+// compact_view
+fsv::compact_view::compact_view(const char* data, std::size_t length, predicate_id id)
+: data_(data) {
+	if (length > max_length) {
+		throw std::length_error("compact_view: length " + std::to_string(length) + " does not fit in 48 bits");
+	}
+	(void)registered_predicate(id);
+	packed_ = std::uint64_t{length} | (std::uint64_t{id} << length_bits);
+}
+fsv::compact_view::compact_view(const filtered_string_view& view, predicate_id id)
+: compact_view(view.data(), view.underlying_size(), id) {}
+auto fsv::compact_view::data() const noexcept -> const char* {
+	return data_;
+}
+auto fsv::compact_view::underlying_size() const noexcept -> std::size_t {
+	return static_cast<std::size_t>(packed_ & max_length);
+}
+auto fsv::compact_view::id() const noexcept -> predicate_id {
+	return static_cast<predicate_id>(packed_ >> length_bits);
+}
+auto fsv::compact_view::predicate() const -> const filter& {
+	return registered_predicate(id());
+}
+auto fsv::compact_view::size() const -> std::size_t {
+	return count_accepted(predicate(), data_, data_ + underlying_size());
+}
+auto fsv::compact_view::empty() const -> bool {
+	return next_accepted(predicate(), data_, data_ + underlying_size()) == data_ + underlying_size();
+}
+auto fsv::compact_view::view() const -> filtered_string_view {
+	return filtered_string_view(data_, underlying_size(), predicate());
+}
+fsv::compact_view::operator filtered_string_view() const {
+	return view();
+}
@@ -0,0 +1,52 @@
+#ifndef COMP6771_ASS2_COMPACT_VIEW_H
+#define COMP6771_ASS2_COMPACT_VIEW_H
+
+#include "./filtered_string_view.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fsv {
+	using predicate_id = std::uint16_t;
+
+	// Process-wide registry of predicates, so a view can name its predicate with a 16-bit id instead of
+	// carrying a std::function. Entries are never changed or removed once registered, which makes lookups
+	// lock-free; registration is serialised. Id 0 accepts every character.
+	inline constexpr std::size_t max_registered_predicates = 65536;
+	// throws std::length_error once all ids are taken
+	auto register_predicate(filter predicate) -> predicate_id;
+	// throws std::out_of_range if id has not been registered
+	auto registered_predicate(predicate_id id) -> const filter&;
+
+	// A 16-byte view: the data pointer plus one word holding a 48-bit length and the predicate id. Three
+	// times smaller than a filtered_string_view, for containers that hold many views.
+	class compact_view {
+	 public:
+		static constexpr std::size_t max_length = (std::uint64_t{1} << 48) - 1;
+
+		compact_view() noexcept = default;
+		// throws std::length_error if length exceeds max_length and std::out_of_range if id is not registered
+		compact_view(const char* data, std::size_t length, predicate_id id = 0);
+		// Converts view, which the caller asserts is filtered by the predicate registered as id. Predicates
+		// cannot be compared, so the id is not checked against the view's predicate.
+		compact_view(const filtered_string_view& view, predicate_id id);
+
+		auto data() const noexcept -> const char*;
+		auto underlying_size() const noexcept -> std::size_t;
+		auto id() const noexcept -> predicate_id;
+		auto predicate() const -> const filter&;
+		auto size() const -> std::size_t;
+		auto empty() const -> bool;
+		auto view() const -> filtered_string_view;
+		explicit operator filtered_string_view() const;
+
+	 private:
+		static constexpr int length_bits = 48;
+
+		const char* data_ = nullptr;
+		// length in the low 48 bits, predicate id in the high 16
+		std::uint64_t packed_ = 0;
+	}; // compact_view
+} // namespace fsv
+
+#endif // COMP6771_ASS2_COMPACT_VIEW_H
@@ -0,0 +1,70 @@
+#include "./compact_view.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("compact_view packs a view into 16 bytes", "[compact_view]") {
+	static_assert(sizeof(fsv::compact_view) == 16);
+	const auto str = std::string("a1b2c3");
+	auto digits = fsv::register_predicate(fsv::byte_set{"0123456789"});
+	CHECK(digits != 0);
+
+	auto cv = fsv::compact_view(str.data(), str.size(), digits);
+	CHECK(cv.data() == str.data());
+	CHECK(cv.underlying_size() == 6);
+	CHECK(cv.id() == digits);
+	CHECK(cv.size() == 3);
+	CHECK_FALSE(cv.empty());
+	CHECK(static_cast<std::string>(cv.view()) == "123");
+	CHECK(cv.predicate().target<fsv::byte_set>() != nullptr);
+
+	auto all = fsv::compact_view(str.data(), str.size());
+	CHECK(static_cast<std::string>(static_cast<fsv::filtered_string_view>(all)) == str);
+	CHECK(fsv::compact_view().empty());
+	CHECK(fsv::compact_view(str.data(), 0, digits).empty());
+}
+TEST_CASE("compact_view converts to and from filtered_string_view", "[compact_view]") {
+	auto upper = fsv::register_predicate([](const char& c) { return std::isupper(static_cast<unsigned char>(c)); });
+	auto sv = fsv::filtered_string_view("HeLLo", fsv::registered_predicate(upper));
+	auto cv = fsv::compact_view(sv, upper);
+	CHECK(cv.data() == sv.data());
+	CHECK(cv.underlying_size() == sv.underlying_size());
+	CHECK(cv.view() == sv);
+	CHECK(static_cast<std::string>(cv.view()) == "HLL");
+}
+TEST_CASE("compact_view rejects unknown ids and oversized lengths", "[compact_view]") {
+	CHECK_THROWS_AS(fsv::registered_predicate(65535), std::out_of_range);
+	CHECK_THROWS_AS(fsv::compact_view("x", 1, 65535), std::out_of_range);
+	CHECK_THROWS_AS(fsv::compact_view("x", fsv::compact_view::max_length + 1), std::length_error);
+}
+TEST_CASE("predicates can be registered and looked up concurrently", "[compact_view]") {
+	// Catch2 assertions are not thread-safe, so the workers only record what they saw
+	auto ids = std::vector<std::vector<fsv::predicate_id>>(4);
+	auto lookups_ok = std::vector<int>(ids.size(), 1);
+	auto threads = std::vector<std::thread>();
+	for (std::size_t t = 0; t < ids.size(); ++t) {
+		threads.emplace_back([&ids, &lookups_ok, t] {
+			for (auto i = 0; i < 50; ++i) {
+				auto c = static_cast<char>('a' + i % 26);
+				auto id = fsv::register_predicate([c](const char& x) { return x == c; });
+				lookups_ok[t] &= fsv::registered_predicate(id)(c) ? 1 : 0;
+				ids[t].push_back(id);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	CHECK(std::ranges::count(lookups_ok, 1) == 4);
+	auto all = std::vector<fsv::predicate_id>();
+	for (const auto& row : ids) {
+		all.insert(all.end(), row.begin(), row.end());
+	}
+	std::ranges::sort(all);
+	CHECK(std::ranges::adjacent_find(all) == all.end());
+}
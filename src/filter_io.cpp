@@ -0,0 +1,129 @@
+#include "./filter_io.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <system_error>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+	auto read_some(int fd, char* buffer, std::size_t count) -> std::size_t {
+		while (true) {
+			auto n = ::read(fd, buffer, count);
+			if (n >= 0) {
+				return static_cast<std::size_t>(n);
+			}
+			if (errno != EINTR) {
+				throw std::system_error(errno, std::generic_category(), "filter_copy: read failed");
+			}
+		}
+	}
+#if defined(IOV_MAX)
+	constexpr auto iov_max = std::size_t{IOV_MAX};
+#else
+	constexpr auto iov_max = std::size_t{1024};
+#endif
+	// writes all of iov[0, count), resuming after partial writes; the iovecs are consumed
+	auto writev_all(int fd, iovec* iov, std::size_t count) -> void {
+		while (count != 0) {
+			auto n = ::writev(fd, iov, static_cast<int>(count));
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw std::system_error(errno, std::generic_category(), "write_runs: writev failed");
+			}
+			auto done = static_cast<std::size_t>(n);
+			while (count != 0 and done >= iov->iov_len) {
+				done -= iov->iov_len;
+				++iov;
+				--count;
+			}
+			if (count != 0) {
+				iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+				iov->iov_len -= done;
+			}
+		}
+	}
+	// write_runs, with the caller providing the staging buffer
+	auto write_runs_via(int fd,
+	                    const fsv::filtered_string_view& fsv,
+	                    std::size_t min_run,
+	                    char* staging,
+	                    std::size_t staging_size) -> std::size_t {
+		auto iov = std::vector<iovec>();
+		auto staged = std::size_t{0};
+		auto written = std::size_t{0};
+		auto flush = [&] {
+			writev_all(fd, iov.data(), iov.size());
+			iov.clear();
+			staged = 0;
+		};
+		fsv.for_each_run([&](const char* run, std::size_t count) {
+			written += count;
+			if (count >= min_run or count > staging_size) {
+				iov.push_back(iovec{const_cast<char*>(run), count});
+			}
+			else {
+				if (staged + count > staging_size) {
+					flush();
+				}
+				auto* dest = staging + staged;
+				std::memcpy(dest, run, count);
+				staged += count;
+				// consecutive short runs share one iovec
+				if (!iov.empty() and static_cast<char*>(iov.back().iov_base) + iov.back().iov_len == dest) {
+					iov.back().iov_len += count;
+				}
+				else {
+					iov.push_back(iovec{dest, count});
+				}
+			}
+			if (iov.size() == iov_max) {
+				flush();
+			}
+		});
+		flush();
+		return written;
+	}
+} // namespace
+
+auto fsv::write_runs(int fd, const filtered_string_view& fsv, std::size_t min_run) -> std::size_t {
+	auto staging_size = std::min(fsv.underlying_size(), default_block_size);
+	auto staging = std::make_unique_for_overwrite<char[]>(staging_size);
+	return write_runs_via(fd, fsv, min_run, staging.get(), staging_size);
+}
+auto fsv::filter_copy(std::istream& in, std::ostream& out, filter predicate, std::size_t block_size) -> std::size_t {
+	auto block = std::make_unique<char[]>(block_size);
+	auto written = std::size_t{0};
+	while (in and out) {
+		in.read(block.get(), static_cast<std::streamsize>(block_size));
+		auto count = static_cast<std::size_t>(in.gcount());
+		if (count == 0) {
+			break;
+		}
+		filtered_string_view(block.get(), count, predicate).for_each_run([&](const char* run, std::size_t n) {
+			out.write(run, static_cast<std::streamsize>(n));
+			written += n;
+			return static_cast<bool>(out);
+		});
+	}
+	return written;
+}
+auto fsv::filter_copy(int in_fd, int out_fd, filter predicate, std::size_t block_size) -> std::size_t {
+	auto block = std::make_unique<char[]>(block_size);
+	// long runs are written straight from the block, short ones compacted into a staging block
+	auto staged = std::make_unique<char[]>(block_size);
+	auto written = std::size_t{0};
+	while (auto count = read_some(in_fd, block.get(), block_size)) {
+		auto view = filtered_string_view(block.get(), count, predicate);
+		written += write_runs_via(out_fd, view, default_min_run, staged.get(), block_size);
+	}
+	return written;
+}
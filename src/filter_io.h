@@ -0,0 +1,29 @@
+#ifndef COMP6771_ASS2_FILTER_IO_H
+#define COMP6771_ASS2_FILTER_IO_H
+
+#include "./filtered_string_view.h"
+
+#include <cstddef>
+#include <iosfwd>
+
+namespace fsv {
+	inline constexpr std::size_t default_block_size = std::size_t{1} << 20;
+
+	// Streams in to out, keeping only the characters accepted by predicate. Input is read in reusable
+	// blocks of block_size bytes and written out one accepted run at a time. Returns the number of
+	// characters written; stops early if out fails.
+	auto filter_copy(std::istream& in, std::ostream& out, filter predicate, std::size_t block_size = default_block_size)
+	    -> std::size_t;
+	// File descriptor version of the above; throws std::system_error if a read or write fails.
+	auto filter_copy(int in_fd, int out_fd, filter predicate, std::size_t block_size = default_block_size)
+	    -> std::size_t;
+
+	// runs shorter than this are copied into a staging buffer rather than given an iovec of their own
+	inline constexpr std::size_t default_min_run = 256;
+	// Writes the filtered characters of fsv to fd with writev: each accepted run of at least min_run
+	// characters is written straight from the underlying string, and shorter runs are gathered into a
+	// staging buffer. Returns the number of characters written; throws std::system_error on failure.
+	auto write_runs(int fd, const filtered_string_view& fsv, std::size_t min_run = default_min_run) -> std::size_t;
+} // namespace fsv
+
+#endif // COMP6771_ASS2_FILTER_IO_H
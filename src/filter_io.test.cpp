@@ -0,0 +1,89 @@
+#include "./filter_io.h"
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+TEST_CASE("filter_copy streams accepted characters across block boundaries", "[filter_io]") {
+	auto input = std::string();
+	for (int i = 0; i < 1000; ++i) {
+		input += "a-b--c---";
+	}
+	auto in = std::istringstream(input);
+	auto out = std::ostringstream();
+	auto written = fsv::filter_copy(in, out, fsv::byte_set{"abc"}, 7);
+	CHECK(written == 3000);
+	CHECK(out.str() == static_cast<std::string>(fsv::filtered_string_view{input, [](const char& c) { return c != '-'; }}));
+}
+TEST_CASE("filter_copy on an empty stream writes nothing", "[filter_io]") {
+	auto in = std::istringstream();
+	auto out = std::ostringstream();
+	CHECK(fsv::filter_copy(in, out, fsv::filtered_string_view::default_predicate) == 0);
+	CHECK(out.str().empty());
+}
+TEST_CASE("filter_copy between file descriptors", "[filter_io]") {
+	auto dir = std::filesystem::temp_directory_path();
+	auto in_path = (dir / "fsv_filter_io_in.txt").string();
+	auto out_path = (dir / "fsv_filter_io_out.txt").string();
+	std::ofstream(in_path, std::ios::binary) << "h3e1l4l1o5 w9o2r6l5d3";
+
+	auto in_fd = ::open(in_path.c_str(), O_RDONLY);
+	auto out_fd = ::open(out_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	REQUIRE(in_fd >= 0);
+	REQUIRE(out_fd >= 0);
+	auto written = fsv::filter_copy(in_fd, out_fd, [](const char& c) { return !std::isdigit(static_cast<unsigned char>(c)); }, 4);
+	::close(in_fd);
+	::close(out_fd);
+
+	CHECK(written == 11);
+	auto result = std::ostringstream();
+	result << std::ifstream(out_path, std::ios::binary).rdbuf();
+	CHECK(result.str() == "hello world");
+	std::filesystem::remove(in_path);
+	std::filesystem::remove(out_path);
+}
+TEST_CASE("filter_copy reports unreadable descriptors", "[filter_io]") {
+	CHECK_THROWS_AS(fsv::filter_copy(-1, 1, fsv::filtered_string_view::default_predicate), std::system_error);
+}
+TEST_CASE("write_runs writes long runs and gathers short ones", "[filter_io]") {
+	// more long runs than fit in one writev, with bursts of short runs in between
+	auto input = std::string();
+	for (int i = 0; i < 3000; ++i) {
+		input += std::string(300, static_cast<char>('a' + i % 20));
+		input += i % 3 == 0 ? "-x-y-z-" : "-";
+	}
+	auto no_dash = fsv::filtered_string_view(input, ~fsv::byte_set{"-"});
+	auto expected = static_cast<std::string>(no_dash);
+
+	int fds[2];
+	REQUIRE(::pipe(fds) == 0);
+	auto received = std::string();
+	auto reader = std::thread([&received, fd = fds[0]] {
+		auto buffer = std::array<char, 4096>{};
+		while (auto n = ::read(fd, buffer.data(), buffer.size())) {
+			if (n < 0) {
+				break;
+			}
+			received.append(buffer.data(), static_cast<std::size_t>(n));
+		}
+	});
+	auto written = fsv::write_runs(fds[1], no_dash);
+	written += fsv::write_runs(fds[1], fsv::filtered_string_view(input, fsv::byte_set{"x"}), 1);
+	::close(fds[1]);
+	reader.join();
+	::close(fds[0]);
+
+	CHECK(written == expected.size() + 1000);
+	CHECK(received == expected + std::string(1000, 'x'));
+}
+TEST_CASE("write_runs reports write failures", "[filter_io]") {
+	CHECK(fsv::write_runs(-1, fsv::filtered_string_view()) == 0);
+	CHECK_THROWS_AS(fsv::write_runs(-1, fsv::filtered_string_view("abc")), std::system_error);
+}
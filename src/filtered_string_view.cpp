@@ -1,6 +1,169 @@
 
 #include "./filtered_string_view.h"
 
+#include <bit>
+#if defined(__x86_64__) && defined(__GNUC__)
+#	include <tmmintrin.h>
+#endif
+
+namespace {
+	auto find_in_scalar(const fsv::byte_set& set, const char* first, const char* last) noexcept -> const char* {
+		return std::find_if(first, last, [&set](const char& c) { return set(c); });
+	}
+	auto rfind_in_scalar(const fsv::byte_set& set, const char* first, const char* last) noexcept -> const char* {
+		while (last != first) {
+			if (set(*--last)) {
+				return last;
+			}
+		}
+		return nullptr;
+	}
+#if defined(__x86_64__) && defined(__GNUC__)
+	auto has_ssse3() noexcept -> bool {
+		static const bool supported = __builtin_cpu_supports("ssse3");
+		return supported;
+	}
+	// Membership test of 16 bytes at once using the nibble-split table: pshufb looks up the row for each
+	// low nibble, and the high nibble picks the row half and the bit within it.
+	struct ssse3_matcher {
+		__m128i low_rows;
+		__m128i high_rows;
+
+		[[gnu::target("ssse3")]] explicit ssse3_matcher(const fsv::byte_set& set) noexcept
+		: low_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data())))
+		, high_rows(_mm_loadu_si128(reinterpret_cast<const __m128i*>(set.table().data() + 16))) {}
+
+		// bit i is set when p[i] is a member
+		[[gnu::target("ssse3")]] auto mask(const char* p) const noexcept -> unsigned {
+			const auto nibble = _mm_set1_epi8(0x0f);
+			const auto bits = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+			auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+			auto lo = _mm_and_si128(bytes, nibble);
+			auto hi = _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble);
+			auto is_low = _mm_cmplt_epi8(hi, _mm_set1_epi8(8));
+			auto row = _mm_or_si128(_mm_and_si128(is_low, _mm_shuffle_epi8(low_rows, lo)),
+			                        _mm_andnot_si128(is_low, _mm_shuffle_epi8(high_rows, lo)));
+			auto bit = _mm_shuffle_epi8(bits, hi);
+			auto hit = _mm_cmpeq_epi8(_mm_and_si128(row, bit), bit);
+			return static_cast<unsigned>(_mm_movemask_epi8(hit));
+		}
+	};
+	[[gnu::target("ssse3")]] auto find_in_ssse3(const fsv::byte_set& set, const char* first, const char* last) noexcept
+	    -> const char* {
+		const auto matcher = ssse3_matcher(set);
+		for (; last - first >= 16; first += 16) {
+			if (auto mask = matcher.mask(first); mask != 0) {
+				return first + std::countr_zero(mask);
+			}
+		}
+		return find_in_scalar(set, first, last);
+	}
+	[[gnu::target("ssse3")]] auto rfind_in_ssse3(const fsv::byte_set& set, const char* first, const char* last) noexcept
+	    -> const char* {
+		const auto matcher = ssse3_matcher(set);
+		while (last - first >= 16) {
+			last -= 16;
+			if (auto mask = matcher.mask(last); mask != 0) {
+				return last + (31 - std::countl_zero(mask));
+			}
+		}
+		return rfind_in_scalar(set, first, last);
+	}
+	[[gnu::target("ssse3")]] auto count_in_ssse3(const fsv::byte_set& set, const char* first, const char* last) noexcept
+	    -> std::size_t {
+		const auto matcher = ssse3_matcher(set);
+		std::size_t count = 0;
+		for (; last - first >= 16; first += 16) {
+			count += static_cast<std::size_t>(std::popcount(matcher.mask(first)));
+		}
+		return count + static_cast<std::size_t>(std::count_if(first, last, [&set](const char& c) { return set(c); }));
+	}
+#endif
+	// first member of set in [first, last), or last
+	auto find_in(const fsv::byte_set& set, const char* first, const char* last) noexcept -> const char* {
+		// the common case while iterating dense input is that the very next character matches
+		if (first == last or set(*first)) {
+			return first;
+		}
+#if defined(__x86_64__) && defined(__GNUC__)
+		if (has_ssse3()) {
+			return find_in_ssse3(set, first + 1, last);
+		}
+#endif
+		return find_in_scalar(set, first + 1, last);
+	}
+	// last member of set in [first, last), or nullptr
+	auto rfind_in(const fsv::byte_set& set, const char* first, const char* last) noexcept -> const char* {
+		if (first == last) {
+			return nullptr;
+		}
+		if (set(*(last - 1))) {
+			return last - 1;
+		}
+#if defined(__x86_64__) && defined(__GNUC__)
+		if (has_ssse3()) {
+			return rfind_in_ssse3(set, first, last - 1);
+		}
+#endif
+		return rfind_in_scalar(set, first, last - 1);
+	}
+	// number of members of set in [first, last)
+	auto count_in(const fsv::byte_set& set, const char* first, const char* last) noexcept -> std::size_t {
+#if defined(__x86_64__) && defined(__GNUC__)
+		if (has_ssse3()) {
+			return count_in_ssse3(set, first, last);
+		}
+#endif
+		return static_cast<std::size_t>(std::count_if(first, last, [&set](const char& c) { return set(c); }));
+	}
+} // namespace
+
+// byte_set
+fsv::byte_set::byte_set(std::string_view chars) noexcept {
+	for (auto c : chars) {
+		insert(c);
+	}
+}
+auto fsv::byte_set::from_predicate(const filter& pred) -> byte_set {
+	auto set = byte_set();
+	for (int b = 0; b < 256; ++b) {
+		auto c = static_cast<char>(b);
+		if (pred(c)) {
+			set.insert(c);
+		}
+	}
+	return set;
+}
+auto fsv::byte_set::insert(char c) noexcept -> void {
+	auto b = static_cast<unsigned char>(c);
+	table_[index(b)] |= static_cast<std::uint8_t>(1u << ((b >> 4) & 0x07));
+}
+auto fsv::byte_set::erase(char c) noexcept -> void {
+	auto b = static_cast<unsigned char>(c);
+	table_[index(b)] &= static_cast<std::uint8_t>(~(1u << ((b >> 4) & 0x07)));
+}
+auto fsv::operator~(const byte_set& set) noexcept -> byte_set {
+	auto result = set;
+	for (auto& row : result.table_) {
+		row = static_cast<std::uint8_t>(~row);
+	}
+	return result;
+}
+auto fsv::operator&(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set {
+	auto result = lhs;
+	for (std::size_t i = 0; i < result.table_.size(); ++i) {
+		result.table_[i] &= rhs.table_[i];
+	}
+	return result;
+}
+auto fsv::operator|(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set {
+	auto result = lhs;
+	for (std::size_t i = 0; i < result.table_.size(); ++i) {
+		result.table_[i] |= rhs.table_[i];
+	}
+	return result;
+}
+
 // Implement here
 fsv::filtered_string_view::filtered_string_view() noexcept
 : data_(nullptr)
@@ -33,7 +196,8 @@ fsv::filtered_string_view::filtered_string_view(const char* str, filter predicat
 
 //  Copy and Move Constructors
 fsv::filtered_string_view::filtered_string_view(const filtered_string_view& other)
-: data_(other.data_)
+: std::ranges::view_interface<filtered_string_view>(other)
+, data_(other.data_)
 , length_(other.length_)
 , predicate_(other.predicate_){};
 // move constructor
@@ -65,54 +229,69 @@ auto fsv::filtered_string_view::operator=(filtered_string_view&& other) noexcept
 	return *this;
 }
 // Subscript not requires bounds checking add noexcept read only const function
-auto fsv::filtered_string_view::operator[](int n) const noexcept -> const char& {
-	int count = 0;
-	for (std::size_t i = 0; i < length_; ++i) {
-		if (predicate_(data_[i])) {
-			if (count == n) {
-				return data_[i];
-			}
-			++count;
-		}
-	}
-	return data_[0];
+auto fsv::filtered_string_view::char_at(std::size_t n) const noexcept -> const char& {
+	auto found = nth_accepted(n);
+	return found ? *found : data_[0];
 }
 // String Type Conversion
 fsv::filtered_string_view::operator std::string() const {
 	std::string result = {};
-	result.reserve(length_);
-	for (std::size_t i = 0; i < length_; ++i) {
-		if (predicate_(data_[i])) {
-			result.push_back(data_[i]);
-		}
+	result.reserve(capacity_hint());
+	for_each_run([&result](const char* run, std::size_t count) { result.append(run, count); });
+	return result;
+}
+auto fsv::filtered_string_view::materialize_into(std::pmr::memory_resource& arena) const -> std::string_view {
+	auto length = size();
+	if (length == 0) {
+		return std::string_view();
+	}
+	auto* chars = static_cast<char*>(arena.allocate(length, alignof(char)));
+	copy(*this, chars);
+	return std::string_view(chars, length);
+}
+auto fsv::filtered_string_view::copy_to(char* dest, std::size_t cap, std::size_t pos) const -> std::size_t {
+	auto skip = pos;
+	auto written = std::size_t{0};
+	for_each_run([&](const char* run, std::size_t count) {
+		auto from = std::min(skip, count);
+		skip -= from;
+		auto n = std::min(count - from, cap - written);
+		std::copy(run + from, run + from + n, dest + written);
+		written += n;
+		return written < cap or skip != 0;
+	});
+	if (skip != 0) {
+		throw std::out_of_range("filtered_string_view::copy_to: pos " + std::to_string(pos) + " > size()");
+	}
+	return written;
+}
+auto fsv::filtered_string_view::assign_to(std::string& out) const -> void {
+	out.clear();
+	append_to(out);
+}
+auto fsv::filtered_string_view::append_to(std::string& out) const -> void {
+	// the hint costs a pass over a byte_set view, so it is only worth it when out may have to grow
+	if (out.capacity() - out.size() < length_) {
+		out.reserve(out.size() + capacity_hint());
 	}
+	for_each_run([&out](const char* run, std::size_t count) { out.append(run, count); });
+}
+auto fsv::filtered_string_view::to_pmr_string(std::pmr::memory_resource* resource) const -> std::pmr::string {
+	auto result = std::pmr::string(size(), '\0', resource);
+	copy(*this, result.data());
 	return result;
 }
 // at() implementation with bounds checking and exception handling
-auto fsv::filtered_string_view::at(int index) const -> const char& {
-	if (index < 0 or static_cast<std::size_t>(index) >= length_ or length_ == 0) {
+auto fsv::filtered_string_view::checked_at(std::size_t index) const -> const char& {
+	auto found = index < length_ ? nth_accepted(index) : nullptr;
+	if (found == nullptr) {
 		throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
 	}
-	int count = 0;
-	for (std::size_t i = 0; i < length_; ++i) {
-		if (predicate_(data_[i])) {
-			if (count == index) {
-				return data_[i];
-			}
-			++count;
-		}
-	}
-	throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
+	return *found;
 }
 // size() implementation
 auto fsv::filtered_string_view::size() const -> std::size_t {
-	std::size_t count = 0;
-	for (std::size_t i = 0; i < length_; ++i) {
-		if (predicate_(data_[i])) {
-			++count;
-		}
-	}
-	return count;
+	return count_accepted(predicate_, data_, data_ + length_);
 }
 // empty() implementation
 auto fsv::filtered_string_view::empty() const -> bool {
@@ -122,9 +301,276 @@ auto fsv::filtered_string_view::empty() const -> bool {
 auto fsv::filtered_string_view::data() const noexcept -> const char* {
 	return data_;
 }
+auto fsv::filtered_string_view::underlying_size() const noexcept -> std::size_t {
+	return length_;
+}
 auto fsv::filtered_string_view::predicate() const noexcept -> const filter& {
 	return predicate_;
 }
+// Search
+auto fsv::filtered_string_view::find(char c, std::size_t pos) const -> std::size_t {
+	if (!predicate_(c)) {
+		return npos;
+	}
+	// every c in the underlying string is accepted, so a plain scan finds the next one
+	auto start = nth_accepted(pos);
+	if (start == nullptr) {
+		return npos;
+	}
+	auto last = data_ + length_;
+	auto hit = static_cast<const char*>(std::memchr(start, c, static_cast<std::size_t>(last - start)));
+	if (hit == nullptr) {
+		return npos;
+	}
+	return pos + count_accepted(predicate_, start, hit);
+}
+auto fsv::filtered_string_view::find(std::string_view str, std::size_t pos) const -> std::size_t {
+	if (str.empty()) {
+		return pos <= size() ? pos : npos;
+	}
+	if (!accepts_all(str)) {
+		return npos;
+	}
+	auto from = nth_accepted(pos);
+	if (from == nullptr) {
+		return npos;
+	}
+	auto last = data_ + length_;
+	for (auto index = pos;;) {
+		auto hit = static_cast<const char*>(std::memchr(from, str.front(), static_cast<std::size_t>(last - from)));
+		if (hit == nullptr) {
+			return npos;
+		}
+		index += count_accepted(predicate_, from, hit);
+		if (matches_at(hit, str)) {
+			return index;
+		}
+		from = hit + 1;
+		++index;
+	}
+}
+auto fsv::filtered_string_view::rfind(char c, std::size_t pos) const -> std::size_t {
+	if (!predicate_(c)) {
+		return npos;
+	}
+	auto end = data_ + length_;
+	if (pos != npos) {
+		if (auto p = nth_accepted(pos)) {
+			end = p + 1;
+		}
+	}
+	auto hit = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(data_), c);
+	if (hit.base() == data_) {
+		return npos;
+	}
+	return count_accepted(predicate_, data_, hit.base() - 1);
+}
+auto fsv::filtered_string_view::rfind(std::string_view str, std::size_t pos) const -> std::size_t {
+	auto total = size();
+	if (str.size() > total) {
+		return npos;
+	}
+	auto start = std::min(pos, total - str.size());
+	if (str.empty()) {
+		return start;
+	}
+	if (!accepts_all(str)) {
+		return npos;
+	}
+	// walk candidates backwards from the last allowed start, keeping the filtered index of p
+	auto p = nth_accepted(start);
+	auto index = start;
+	for (auto end = p + 1;;) {
+		auto hit = std::find(std::make_reverse_iterator(end), std::make_reverse_iterator(data_), str.front());
+		if (hit.base() == data_) {
+			return npos;
+		}
+		auto candidate = hit.base() - 1;
+		index -= count_accepted(predicate_, candidate, p);
+		p = candidate;
+		if (matches_at(p, str)) {
+			return index;
+		}
+		end = p;
+	}
+}
+auto fsv::filtered_string_view::contains(char c) const -> bool {
+	return find(c) != npos;
+}
+auto fsv::filtered_string_view::contains(std::string_view str) const -> bool {
+	return find(str) != npos;
+}
+auto fsv::filtered_string_view::count(char c) const -> std::size_t {
+	if (!predicate_(c)) {
+		return 0;
+	}
+	return static_cast<std::size_t>(std::count(data_, data_ + length_, c));
+}
+auto fsv::filtered_string_view::find_first_of(std::string_view chars, std::size_t pos) const -> std::size_t {
+	// only the members of chars that the predicate accepts can be found
+	auto wanted = byte_set();
+	for (auto c : chars) {
+		if (predicate_(c)) {
+			wanted.insert(c);
+		}
+	}
+	auto start = nth_accepted(pos);
+	if (start == nullptr) {
+		return npos;
+	}
+	auto last = data_ + length_;
+	auto hit = find_in(wanted, start, last);
+	if (hit == last) {
+		return npos;
+	}
+	return pos + count_accepted(predicate_, start, hit);
+}
+auto fsv::filtered_string_view::find_first_not_of(std::string_view chars, std::size_t pos) const -> std::size_t {
+	auto start = nth_accepted(pos);
+	if (start == nullptr) {
+		return npos;
+	}
+	auto last = data_ + length_;
+	auto unwanted = ~byte_set(chars);
+	if (auto set = predicate_.target<byte_set>()) {
+		// accepted and not in chars, in one scan
+		auto hit = find_in(*set & unwanted, start, last);
+		return hit == last ? npos : pos + count_in(*set, start, hit);
+	}
+	auto found = npos;
+	auto index = pos;
+	fsv::for_each_run(predicate_, start, last, [&](const char* run, std::size_t count) {
+		auto hit = find_in(unwanted, run, run + count);
+		if (hit != run + count) {
+			found = index + static_cast<std::size_t>(hit - run);
+			return false;
+		}
+		index += count;
+		return true;
+	});
+	return found;
+}
+auto fsv::filtered_string_view::starts_with(char c) const -> bool {
+	auto last = data_ + length_;
+	auto first = next_accepted(data_, last);
+	return first != last and *first == c;
+}
+auto fsv::filtered_string_view::starts_with(std::string_view str) const -> bool {
+	if (str.empty()) {
+		return true;
+	}
+	auto last = data_ + length_;
+	auto first = next_accepted(data_, last);
+	return first != last and *first == str.front() and matches_at(first, str);
+}
+auto fsv::filtered_string_view::ends_with(char c) const -> bool {
+	auto back = prev_accepted(data_, data_ + length_);
+	return back != nullptr and *back == c;
+}
+auto fsv::filtered_string_view::ends_with(std::string_view str) const -> bool {
+	auto end = data_ + length_;
+	for (auto k = str.size(); k != 0; --k) {
+		end = prev_accepted(data_, end);
+		if (end == nullptr or *end != str[k - 1]) {
+			return false;
+		}
+	}
+	return true;
+}
+auto fsv::filtered_string_view::matches_at(const char* p, std::string_view str) const -> bool {
+	auto last = data_ + length_;
+	for (std::size_t k = 1; k < str.size(); ++k) {
+		p = fsv::next_accepted(predicate_, p + 1, last);
+		if (p == last or *p != str[k]) {
+			return false;
+		}
+	}
+	return true;
+}
+auto fsv::filtered_string_view::accepts_all(std::string_view str) const -> bool {
+	return std::all_of(str.begin(), str.end(), [this](const char& c) { return predicate_(c); });
+}
+auto fsv::filtered_string_view::nth_accepted(std::size_t n) const -> const char* {
+	const char* found = nullptr;
+	for_each_run([&n, &found](const char* run, std::size_t count) {
+		if (n < count) {
+			found = run + n;
+			return false;
+		}
+		n -= count;
+		return true;
+	});
+	return found;
+}
+auto fsv::filtered_string_view::capacity_hint() const -> std::size_t {
+	if (auto set = predicate_.target<byte_set>()) {
+		return count_in(*set, data_, data_ + length_);
+	}
+	// sampling a short view would cost about as much as filtering it
+	constexpr auto windows = std::size_t{8};
+	constexpr auto window_size = std::size_t{64};
+	if (length_ <= 4 * windows * window_size) {
+		return length_;
+	}
+	auto sampled = std::size_t{0};
+	auto stride = (length_ - window_size) / (windows - 1);
+	for (std::size_t i = 0; i < windows; ++i) {
+		auto window = data_ + i * stride;
+		sampled += count_accepted(predicate_, window, window + window_size);
+	}
+	auto estimate = length_ * sampled / (windows * window_size);
+	// near-total acceptance: reserving everything is cheaper than a late reallocation
+	if (estimate >= length_ - length_ / 4) {
+		return length_;
+	}
+	// headroom for sampling error; a larger result grows the string as usual
+	return std::min(length_, estimate + estimate / 8 + window_size);
+}
+auto fsv::filtered_string_view::next_accepted(const char* first, const char* last) const -> const char* {
+	return fsv::next_accepted(predicate_, first, last);
+}
+auto fsv::filtered_string_view::next_rejected(const char* first, const char* last) const -> const char* {
+	return fsv::next_rejected(predicate_, first, last);
+}
+auto fsv::filtered_string_view::prev_accepted(const char* first, const char* last) const -> const char* {
+	return fsv::prev_accepted(predicate_, first, last);
+}
+// Run primitives
+auto fsv::next_accepted(const filter& predicate, const char* first, const char* last) -> const char* {
+	if (auto set = predicate.target<byte_set>()) {
+		return find_in(*set, first, last);
+	}
+	while (first != last and !predicate(*first)) {
+		++first;
+	}
+	return first;
+}
+auto fsv::next_rejected(const filter& predicate, const char* first, const char* last) -> const char* {
+	if (auto set = predicate.target<byte_set>()) {
+		return find_in(~*set, first, last);
+	}
+	while (first != last and predicate(*first)) {
+		++first;
+	}
+	return first;
+}
+auto fsv::prev_accepted(const filter& predicate, const char* first, const char* last) -> const char* {
+	if (auto set = predicate.target<byte_set>()) {
+		return rfind_in(*set, first, last);
+	}
+	while (last != first) {
+		if (predicate(*--last)) {
+			return last;
+		}
+	}
+	return nullptr;
+}
+auto fsv::count_accepted(const filter& predicate, const char* first, const char* last) -> std::size_t {
+	if (auto set = predicate.target<byte_set>()) {
+		return count_in(*set, first, last);
+	}
+	return static_cast<std::size_t>(std::count_if(first, last, [&predicate](const char& c) { return predicate(c); }));
+}
 // Non-member operator
 auto fsv::operator==(const filtered_string_view& lhs, const filtered_string_view& rhs) noexcept -> bool {
 	std::string ls = lhs.operator std::string();
@@ -141,10 +587,42 @@ auto fsv::operator<=>(const filtered_string_view& lhs, const filtered_string_vie
 	std::string rs = rhs.operator std::string();
 	return ls <=> rs;
 }
+auto fsv::detail::compare(const filtered_string_view& fsv, std::string_view str) -> int {
+	auto result = 0;
+	auto matched = std::size_t{0};
+	fsv.for_each_run([&](const char* run, std::size_t count) {
+		auto n = std::min(count, str.size() - matched);
+		if (n != 0) {
+			result = std::memcmp(run, str.data() + matched, n);
+		}
+		if (result == 0 and n < count) {
+			result = 1; // str is a proper prefix of fsv
+		}
+		matched += n;
+		return result == 0;
+	});
+	if (result == 0 and matched < str.size()) {
+		result = -1;
+	}
+	return result;
+}
+auto fsv::detail::equal(const filtered_string_view& fsv, std::string_view str) -> bool {
+	// too few characters to filter down to str
+	if (fsv.underlying_size() < str.size()) {
+		return false;
+	}
+	return compare(fsv, str) == 0;
+}
 // Output stream
 auto fsv::operator<<(std::ostream& os, const filtered_string_view& fsv) -> std::ostream& {
-	std::string filtered = static_cast<std::string>(fsv);
-	os << filtered;
+	// padding to a field width needs the whole string up front
+	if (os.width() != 0) {
+		return os << static_cast<std::string>(fsv);
+	}
+	fsv.for_each_run([&os](const char* run, std::size_t count) {
+		os.write(run, static_cast<std::streamsize>(count));
+		return static_cast<bool>(os);
+	});
 	return os;
 }
 // Non-member utility functions
@@ -159,13 +637,13 @@ auto fsv::compose(const filtered_string_view& fsv, const std::vector<filter>& fi
 		return true; // If all filters return true, the combined filter returns true
 	};
 	// Return a new filtered_string_view using the original string data and the combined filter
-	return filtered_string_view(fsv.data(), combined_filter);
+	return filtered_string_view(fsv.data(), fsv.underlying_size(), combined_filter);
 }
 
 fsv::filtered_string_view::filtered_string_view(const char* data, size_t length, filter pred) noexcept
 : data_(data)
 , length_(length)
-, predicate_(pred) {}
+, predicate_(std::move(pred)) {}
 
 auto fsv::split(const filtered_string_view& fsv, const filtered_string_view& tok) -> std::vector<filtered_string_view> {
 	std::vector<filtered_string_view> parts;
@@ -176,14 +654,15 @@ auto fsv::split(const filtered_string_view& fsv, const filtered_string_view& tok
 
 	const char* base = fsv.data();
 	const char* current = base;
-	const char* end = base + strlen(base); // using strlen to get the length of the string
+	// the underlying buffers need not be null-terminated (e.g. a mapped_file)
+	const char* end = base + fsv.underlying_size();
 	const char* delim_start = tok.data();
-	size_t delim_size = strlen(delim_start); // using strlen to get the length of the string
+	size_t delim_size = tok.underlying_size();
 
 	while (current < end) {
 		const char* found = std::search(current, end, delim_start, delim_start + delim_size);
 		if (found != current) {
-			parts.emplace_back(current, found - current, fsv.predicate()); // add current part
+			parts.emplace_back(current, static_cast<size_t>(found - current), fsv.predicate()); // add current part
 		}
 		else {
 			parts.emplace_back("", 0, fsv.predicate()); // deal with empty part
@@ -193,7 +672,7 @@ auto fsv::split(const filtered_string_view& fsv, const filtered_string_view& tok
 			break;
 	}
 	if (current < end) {
-		parts.emplace_back(current, end - current, fsv.predicate());
+		parts.emplace_back(current, static_cast<size_t>(end - current), fsv.predicate());
 	}
 	else if (current == end && delim_size > 0 && end != base) {
 		// 处理字符串末尾是分隔符的情况
@@ -202,42 +681,50 @@ auto fsv::split(const filtered_string_view& fsv, const filtered_string_view& tok
 	return parts.empty() ? std::vector<filtered_string_view>{fsv} : parts;
 }
 // subscript utility fucntion
-auto fsv::substr(const filtered_string_view& fsv, int pos, int count) noexcept -> filtered_string_view {
-	if (pos < 0) {
-		pos = 0;
-	}
-	if (static_cast<size_t>(pos) >= fsv.size()) {
-		return filtered_string_view("", 0, fsv.predicate());
-	}
-	std::vector<size_t> indices = fsv.filtered_indices();
-	if (indices.empty() || pos >= static_cast<int>(indices.size())) {
+auto fsv::detail::substr(const filtered_string_view& fsv, std::size_t pos, std::size_t count) noexcept
+    -> filtered_string_view {
+	const char* start = nullptr;
+	const char* stop = nullptr;
+	auto remaining = count == 0 ? std::numeric_limits<std::size_t>::max() : count;
+	fsv.for_each_run([&](const char* run, std::size_t n) {
+		if (start == nullptr) {
+			if (pos >= n) {
+				pos -= n;
+				return true;
+			}
+			start = run + pos;
+			run += pos;
+			n -= pos;
+		}
+		if (remaining <= n) {
+			stop = run + remaining;
+			return false;
+		}
+		remaining -= n;
+		stop = run + n;
+		return true;
+	});
+	if (start == nullptr) {
 		return filtered_string_view("", 0, fsv.predicate());
 	}
-	size_t start_index = indices[static_cast<size_t>(pos)];
-	size_t end_index = (count > 0 && static_cast<size_t>(pos + count) < indices.size())
-	                       ? indices[static_cast<size_t>(pos + count) - 1] + 1
-	                       : indices.back() + 1;
-	return filtered_string_view(fsv.data() + start_index, end_index - start_index, fsv.predicate());
+	return filtered_string_view(start, static_cast<std::size_t>(stop - start), fsv.predicate());
 }
 // iterator personal constructor
 fsv::filtered_string_view::iter::iter(const char* ptr, const filtered_string_view* container) noexcept
 : ptr_(ptr)
 , container_(container) {}
-// iterator default constructor
 auto fsv::filtered_string_view::iter::operator*() const -> reference {
 	return *ptr_;
 }
 //-> operator
 auto fsv::filtered_string_view::iter::operator->() const -> pointer {
-	return;
+	return ptr_;
 }
 auto fsv::filtered_string_view::iter::operator++() -> iter& {
 	// assume ptr is a pointer to current character
-	if (ptr_ and ptr_ < container_->data_ + container_->length_) { // 确保不是空指针且未到达终结符
-		do {
-			++ptr_; // 移动到下一个字符
-		} while (ptr_ < container_->data_ + container_->length_
-		         and !container_->predicate_(*ptr_)); // 继续移动直到找到符合谓词的字符或到达字符串末尾
+	auto last = container_->data_ + container_->length_;
+	if (ptr_ and ptr_ < last) { // 确保不是空指针且未到达终结符
+		ptr_ = container_->next_accepted(ptr_ + 1, last); // 跳到下一个符合谓词的字符或字符串末尾
 	}
 	return *this;
 }
@@ -249,10 +736,9 @@ auto fsv::filtered_string_view::iter::operator++(int) -> iter {
 auto fsv::filtered_string_view::iter::operator--() -> iter& {
 	// assume ptr is a pointer to current character
 	if (ptr_ > container_->data_) { // 确保不是空指针且未到达终结符
-		do {
-			--ptr_; // 移动到下一个字符
-		} while (ptr_ >= container_->data_
-		         and !container_->predicate_(*ptr_)); // 继续移动直到找到符合谓词的字符或到达字符串末尾
+		// 跳到上一个符合谓词的字符; 没有则停在字符串开头
+		auto prev = container_->prev_accepted(container_->data_, ptr_);
+		ptr_ = prev ? prev : container_->data_;
 	}
 	return *this;
 }
@@ -264,11 +750,7 @@ auto fsv::filtered_string_view::iter::operator--(int) -> iter {
 
 // iterator start end
 auto fsv::filtered_string_view::begin() const noexcept -> iter {
-	const char* start = data_;
-	while (start < data_ + length_ and !predicate_(*start)) {
-		++start;
-	}
-	return iter(start, this);
+	return iter(next_accepted(data_, data_ + length_), this);
 }
 auto fsv::filtered_string_view::end() const noexcept -> iter {
 	return iter(data_ + length_, this);
@@ -294,3 +776,73 @@ auto fsv::filtered_string_view::crbegin() const noexcept -> const_reverse_iterat
 auto fsv::filtered_string_view::crend() const noexcept -> const_reverse_iterator {
 	return const_reverse_iterator(begin());
 }
+// hasher
+namespace {
+	constexpr auto hash_multiplier = std::uint64_t{0x9e3779b97f4a7c15};
+	constexpr auto hash_final_multiplier = std::uint64_t{0xbf58476d1ce4e5b9};
+	// 64x64 -> 128-bit multiply, folded back to 64 bits
+	auto fold_multiply(std::uint64_t a, std::uint64_t b) noexcept -> std::uint64_t {
+#if defined(__SIZEOF_INT128__)
+		__extension__ using uint128 = unsigned __int128;
+		auto product = static_cast<uint128>(a) * b;
+		return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+		auto a_lo = a & 0xffffffff, a_hi = a >> 32, b_lo = b & 0xffffffff, b_hi = b >> 32;
+		auto lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo, lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+		auto cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+		auto high = hi_hi + (hi_lo >> 32) + (cross >> 32);
+		return (a * b) ^ high;
+#endif
+	}
+} // namespace
+fsv::hasher::hasher(std::uint64_t seed) noexcept
+: state_(seed) {}
+auto fsv::hasher::mix_word(const char* word) noexcept -> void {
+	auto value = std::uint64_t{0};
+	std::memcpy(&value, word, sizeof(value));
+	state_ = fold_multiply(state_ ^ value, hash_multiplier);
+}
+auto fsv::hasher::update(const char* data, std::size_t count) noexcept -> void {
+	if (count == 0) {
+		return;
+	}
+	length_ += count;
+	if (partial_size_ != 0) {
+		auto take = std::min(count, partial_.size() - partial_size_);
+		std::memcpy(partial_.data() + partial_size_, data, take);
+		partial_size_ += take;
+		data += take;
+		count -= take;
+		if (partial_size_ < partial_.size()) {
+			return;
+		}
+		mix_word(partial_.data());
+		partial_size_ = 0;
+	}
+	for (; count >= 8; data += 8, count -= 8) {
+		mix_word(data);
+	}
+	if (count != 0) {
+		std::memcpy(partial_.data(), data, count);
+		partial_size_ = count;
+	}
+}
+auto fsv::hasher::digest() const noexcept -> std::uint64_t {
+	auto state = state_;
+	if (partial_size_ != 0) {
+		auto tail = std::uint64_t{0};
+		std::memcpy(&tail, partial_.data(), partial_size_);
+		state = fold_multiply(state ^ tail, hash_multiplier);
+	}
+	return fold_multiply(state ^ length_, hash_final_multiplier);
+}
+auto fsv::hash_value(std::string_view str) noexcept -> std::size_t {
+	auto h = hasher();
+	h.update(str.data(), str.size());
+	return static_cast<std::size_t>(h.digest());
+}
+auto fsv::hash_value(const filtered_string_view& fsv) -> std::size_t {
+	auto h = hasher();
+	fsv.for_each_run([&h](const char* run, std::size_t count) { h.update(run, count); });
+	return static_cast<std::size_t>(h.digest());
+}
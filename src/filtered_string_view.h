@@ -2,43 +2,116 @@
 #define COMP6771_ASS2_FSV_H
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cctype>
 #include <compare>
+#include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory_resource>
 #include <optional>
+#include <ranges>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>
 #include <vector>
+#include <version>
+#if defined(__cpp_lib_format)
+#	include <format>
+#endif
 namespace fsv {
 	using filter = std::function<bool(const char&)>;
-	class filtered_string_view {
+	// A predicate backed by a 256-entry membership table. Views whose predicate is a byte_set skip over
+	// rejected characters with a vectorized scan instead of calling the predicate once per character.
+	class byte_set {
+	 public:
+		byte_set() noexcept = default;
+		// accepts exactly the characters in chars
+		explicit byte_set(std::string_view chars) noexcept;
+		// tabulate an arbitrary predicate over all 256 byte values
+		static auto from_predicate(const filter& pred) -> byte_set;
+
+		auto operator()(const char& c) const noexcept -> bool {
+			auto b = static_cast<unsigned char>(c);
+			return (table_[index(b)] >> ((b >> 4) & 0x07)) & 1;
+		}
+		auto insert(char c) noexcept -> void;
+		auto erase(char c) noexcept -> void;
+		// nibble-split layout used by the vectorized scan: byte (hi << 4 | lo) is bit (hi & 7) of
+		// table()[lo + 16 * (hi >= 8)]
+		auto table() const noexcept -> const std::array<std::uint8_t, 32>& {
+			return table_;
+		}
+
+		friend auto operator~(const byte_set& set) noexcept -> byte_set;
+		friend auto operator&(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set;
+		friend auto operator|(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set;
+		friend auto operator==(const byte_set& lhs, const byte_set& rhs) noexcept -> bool = default;
+
+	 private:
+		static auto index(unsigned char b) noexcept -> std::size_t {
+			return static_cast<std::size_t>((b & 0x0f) | ((b >> 3) & 0x10));
+		}
+
+		std::array<std::uint8_t, 32> table_ = {};
+	}; // byte_set
+	auto operator~(const byte_set& set) noexcept -> byte_set;
+	auto operator&(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set;
+	auto operator|(const byte_set& lhs, const byte_set& rhs) noexcept -> byte_set;
+
+	// Run primitives over a raw buffer, for containers that keep a view as separate pieces instead of a
+	// filtered_string_view. They use the SIMD kernels when predicate holds a byte_set.
+	// first accepted character in [first, last), or last
+	auto next_accepted(const filter& predicate, const char* first, const char* last) -> const char*;
+	// first rejected character in [first, last), or last
+	auto next_rejected(const filter& predicate, const char* first, const char* last) -> const char*;
+	// last accepted character in [first, last), or nullptr
+	auto prev_accepted(const filter& predicate, const char* first, const char* last) -> const char*;
+	// number of accepted characters in [first, last)
+	auto count_accepted(const filter& predicate, const char* first, const char* last) -> std::size_t;
+	// Calls f(run, count) for each maximal run of accepted characters in [first, last). If f returns
+	// bool, returning false stops the walk.
+	template<typename F>
+	auto for_each_run(const filter& predicate, const char* first, const char* last, F&& f) -> void {
+		for (auto run = next_accepted(predicate, first, last); run != last;) {
+			auto run_end = next_rejected(predicate, run, last);
+			auto count = static_cast<std::size_t>(run_end - run);
+			if constexpr (std::is_same_v<std::invoke_result_t<F&, const char*, std::size_t>, bool>) {
+				if (!f(run, count)) {
+					return;
+				}
+			}
+			else {
+				f(run, count);
+			}
+			run = next_accepted(predicate, run_end, last);
+		}
+	}
+	class filtered_string_view : public std::ranges::view_interface<filtered_string_view> {
 		class iter {
 		 public:
-			using MEMBER_TYPEDEFS_GO_HERE = void;
-			// define the iterator
-
 			using iterator_category = std::bidirectional_iterator_tag;
 			using value_type = char;
 			using reference = const char&;
-			using pointer = void;
+			using pointer = const char*;
 			using difference_type = std::ptrdiff_t;
 
-			//
-			iter() = default;
-			// Constructors
-			iter(const char* ptr = nullptr, const filtered_string_view* container = nullptr) noexcept;
+			// a singular iterator, only valid to assign to or compare with another singular iterator
+			iter() noexcept = default;
+			iter(const char* ptr, const filtered_string_view* container) noexcept;
 
-			auto operator*() const -> reference; // change this
-			auto operator->() const -> pointer; // change this
+			auto operator*() const -> reference;
+			auto operator->() const -> pointer;
 
 			auto operator++() -> iter&;
 			auto operator++(int) -> iter;
@@ -51,11 +124,27 @@ namespace fsv {
 			friend auto operator!=(const iter& rhs, const iter& lhs) -> bool {
 				return !(lhs == rhs);
 			}
+			// Bulk copy of [first, last) one accepted run at a time. Found by argument-dependent lookup, so
+			// `using std::copy; copy(first, last, out)` picks this over the per-character std::copy.
+			template<typename OutputIt>
+			friend auto copy(iter first, iter last, OutputIt out) -> OutputIt {
+				first.for_each_run_until(last, [&out](const char* run, std::size_t count) {
+					out = std::copy(run, run + count, out);
+				});
+				return out;
+			}
 
 		 private:
+			template<typename F>
+			auto for_each_run_until(const iter& last, F f) const -> void {
+				if (ptr_ != last.ptr_) {
+					container_->for_each_run_in(ptr_, last.ptr_, f);
+				}
+			}
+
 			/* Implementation-specific private members */
-			const char* ptr_;
-			const filtered_string_view* container_;
+			const char* ptr_ = nullptr;
+			const filtered_string_view* container_ = nullptr;
 
 			// friend class filtered_string_view;
 
@@ -76,6 +165,7 @@ namespace fsv {
 		const_reverse_iterator crbegin() const noexcept;
 		const_reverse_iterator crend() const noexcept;
 		static filter default_predicate;
+		static constexpr std::size_t npos = std::string_view::npos;
 		// default constructor initialize the data_ to nullptr, length_ to 0 and predicate_ to default_predicate
 		filtered_string_view() noexcept;
 		filtered_string_view(const std::string& str) noexcept;
@@ -93,11 +183,42 @@ namespace fsv {
 		// Move assignment
 		auto operator=(filtered_string_view&& other) noexcept -> filtered_string_view&;
 		// Subscript
-		auto operator[](int n) const noexcept -> const char&;
+		// any integer type; a negative index refers to the first underlying character
+		template<std::integral Index>
+		auto operator[](Index n) const noexcept -> const char& {
+			if constexpr (std::is_signed_v<Index>) {
+				if (n < 0) {
+					return data_[0];
+				}
+			}
+			return char_at(static_cast<std::size_t>(n));
+		}
 		// String Type Conversion
 		explicit operator std::string() const;
+		// Copies the filtered characters into memory from arena, allocated as exactly size() bytes with
+		// alignment alignof(char), and returns a view of them. An empty view allocates nothing. Memory
+		// given back to arena must be deallocated with that same size and alignment.
+		auto materialize_into(std::pmr::memory_resource& arena) const -> std::string_view;
+		// Like std::string_view::copy: writes up to cap filtered characters, starting at filtered position
+		// pos, to dest and returns how many were written. Throws std::out_of_range if pos > size().
+		auto copy_to(char* dest, std::size_t cap, std::size_t pos = 0) const -> std::size_t;
+		// Replace or extend the contents of out with the filtered characters, reusing its capacity, so a
+		// scratch string can be filled once per record without allocating.
+		auto assign_to(std::string& out) const -> void;
+		auto append_to(std::string& out) const -> void;
+		// a named function rather than a conversion, which would make std::string conversions ambiguous
+		auto to_pmr_string(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+		    -> std::pmr::string;
 		// at() implementation
-		auto at(int index) const -> const char&;
+		template<std::integral Index>
+		auto at(Index index) const -> const char& {
+			if constexpr (std::is_signed_v<Index>) {
+				if (index < 0) {
+					throw std::domain_error("filtered_string_view::at(" + std::to_string(index) + "): invalid index");
+				}
+			}
+			return checked_at(static_cast<std::size_t>(index));
+		}
 
 		// size() implemantation
 		auto size() const -> std::size_t;
@@ -105,9 +226,38 @@ namespace fsv {
 		auto empty() const -> bool;
 
 		auto data() const noexcept -> const char*;
+		// number of characters in the underlying buffer, before filtering
+		auto underlying_size() const noexcept -> std::size_t;
 
 		auto predicate() const noexcept -> const filter&;
 
+		// Search on the filtered sequence. Positions are filtered positions and npos means not found. A
+		// character the predicate rejects is never found, and an accepted one is found with memchr-style
+		// scans of the underlying string; table predicates also count positions with the SIMD kernel.
+		auto find(char c, std::size_t pos = 0) const -> std::size_t;
+		auto find(std::string_view str, std::size_t pos = 0) const -> std::size_t;
+		// the needle is materialized once, then searched for as a string
+		template<std::same_as<filtered_string_view> View>
+		auto find(const View& str, std::size_t pos = 0) const -> std::size_t {
+			return find(std::string_view(static_cast<std::string>(str)), pos);
+		}
+		auto rfind(char c, std::size_t pos = npos) const -> std::size_t;
+		auto rfind(std::string_view str, std::size_t pos = npos) const -> std::size_t;
+		template<std::same_as<filtered_string_view> View>
+		auto rfind(const View& str, std::size_t pos = npos) const -> std::size_t {
+			return rfind(std::string_view(static_cast<std::string>(str)), pos);
+		}
+		auto contains(char c) const -> bool;
+		auto contains(std::string_view str) const -> bool;
+		auto count(char c) const -> std::size_t;
+		auto find_first_of(std::string_view chars, std::size_t pos = 0) const -> std::size_t;
+		auto find_first_not_of(std::string_view chars, std::size_t pos = 0) const -> std::size_t;
+		// only walk as many accepted characters as the prefix or suffix is long
+		auto starts_with(char c) const -> bool;
+		auto starts_with(std::string_view str) const -> bool;
+		auto ends_with(char c) const -> bool;
+		auto ends_with(std::string_view str) const -> bool;
+
 		std::vector<std::size_t> filtered_indices() const {
 			std::vector<std::size_t> indices;
 			for (std::size_t i = 0; i < length_; ++i) {
@@ -118,7 +268,39 @@ namespace fsv {
 			return indices;
 		}
 
+		// Calls f(run, count) for each maximal run of accepted characters, in order. If f returns bool,
+		// returning false stops the walk.
+		template<typename F>
+		auto for_each_run(F f) const -> void {
+			for_each_run_in(data_, data_ + length_, f);
+		}
+
 	 private:
+		// first accepted character in [first, last), or last
+		auto next_accepted(const char* first, const char* last) const -> const char*;
+		// first rejected character in [first, last), or last
+		auto next_rejected(const char* first, const char* last) const -> const char*;
+		// last accepted character in [first, last), or nullptr
+		auto prev_accepted(const char* first, const char* last) const -> const char*;
+		// the n-th accepted character, or nullptr
+		auto nth_accepted(std::size_t n) const -> const char*;
+		// operator[] and at() once the index is known to be non-negative
+		auto char_at(std::size_t n) const noexcept -> const char&;
+		auto checked_at(std::size_t n) const -> const char&;
+		// whether the accepted characters from p, which must be accepted, start with str
+		auto matches_at(const char* p, std::string_view str) const -> bool;
+		// whether every character of str is accepted, so that it could occur in the filtered sequence
+		auto accepts_all(std::string_view str) const -> bool;
+		// How much to reserve before materializing. Exact for a byte_set, which can be counted with the
+		// vectorized kernel; otherwise estimated from a few samples, falling back to length_ when nearly
+		// everything is accepted.
+		auto capacity_hint() const -> std::size_t;
+
+		template<typename F>
+		auto for_each_run_in(const char* first, const char* last, F& f) const -> void {
+			fsv::for_each_run(predicate_, first, last, f);
+		}
+
 		const char* data_;
 		// set the length of view
 		std::size_t length_;
@@ -133,6 +315,25 @@ namespace fsv {
 	auto operator!=(const filtered_string_view& lhs, const filtered_string_view& rhs) noexcept -> bool;
 	// Relational operators
 	auto operator<=>(const filtered_string_view& lhs, const filtered_string_view& rhs) noexcept -> std::strong_ordering;
+	namespace detail {
+		// three-way comparison of the filtered characters with str, run by run and without materializing
+		auto compare(const filtered_string_view& fsv, std::string_view str) -> int;
+		auto equal(const filtered_string_view& fsv, std::string_view str) -> bool;
+
+		template<typename T>
+		concept string_like = std::convertible_to<const T&, std::string_view>
+		                      and not std::is_same_v<std::remove_cvref_t<T>, filtered_string_view>;
+	} // namespace detail
+	// Comparisons with anything convertible to std::string_view. These are templates so that they beat
+	// converting the string to a filtered_string_view; the reversed forms come from the C++20 rewrites.
+	template<detail::string_like T>
+	auto operator==(const filtered_string_view& lhs, const T& rhs) -> bool {
+		return detail::equal(lhs, std::string_view(rhs));
+	}
+	template<detail::string_like T>
+	auto operator<=>(const filtered_string_view& lhs, const T& rhs) -> std::strong_ordering {
+		return detail::compare(lhs, std::string_view(rhs)) <=> 0;
+	}
 	// ostream operator
 	auto operator<<(std::ostream& os, const filtered_string_view& fsv) -> std::ostream&;
 	// Non-member utility functions
@@ -141,8 +342,162 @@ namespace fsv {
 	// split utility function
 	auto split(const filtered_string_view& fsv, const filtered_string_view& tok) -> std::vector<filtered_string_view>;
 	// substring utility function
-	auto substr(const filtered_string_view& fsv, int pos = 0, int count = 0) noexcept -> filtered_string_view;
+	namespace detail {
+		// count == 0 means up to the end of the view
+		auto substr(const filtered_string_view& fsv, std::size_t pos, std::size_t count) noexcept
+		    -> filtered_string_view;
+
+		template<std::integral T>
+		constexpr auto clamp_to_index(T value) noexcept -> std::size_t {
+			if constexpr (std::is_signed_v<T>) {
+				if (value < 0) {
+					return 0;
+				}
+			}
+			return static_cast<std::size_t>(value);
+		}
+	} // namespace detail
+	// Accepts any integer types. Negative positions clamp to the start, and a count that is zero or
+	// negative runs to the end of the view.
+	template<std::integral Pos = int, std::integral Count = int>
+	auto substr(const filtered_string_view& fsv, Pos pos = 0, Count count = 0) noexcept -> filtered_string_view {
+		return detail::substr(fsv, detail::clamp_to_index(pos), detail::clamp_to_index(count));
+	}
+	// copy the filtered characters of fsv to out, one accepted run at a time
+	template<typename OutputIt>
+	auto copy(const filtered_string_view& fsv, OutputIt out) -> OutputIt {
+		fsv.for_each_run([&out](const char* run, std::size_t count) { out = std::copy(run, run + count, out); });
+		return out;
+	}
+
+	namespace detail {
+		// The std::formatter specialization below, kept free of <format> so it builds everywhere.
+		struct format_spec {
+			char fill = ' ';
+			char align = '<';
+			std::size_t width = 0;
+		};
+		// Parses [[fill]align][width][s] from [first, last) into spec. Returns the position of the closing
+		// '}' (or last), or nullopt when the specification is malformed. '{' and '}' cannot be fill.
+		template<typename It>
+		constexpr auto parse_format_spec(It first, It last, format_spec& spec) -> std::optional<It> {
+			auto is_align = [](char c) { return c == '<' or c == '>' or c == '^'; };
+			if (first != last and *first != '}') {
+				auto second = std::next(first);
+				if (second != last and is_align(*second)) {
+					if (*first == '{') {
+						return std::nullopt;
+					}
+					spec.fill = *first;
+					spec.align = *second;
+					first = std::next(second);
+				}
+				else if (is_align(*first)) {
+					spec.align = *first;
+					++first;
+				}
+			}
+			for (; first != last and *first >= '0' and *first <= '9'; ++first) {
+				spec.width = spec.width * 10 + static_cast<std::size_t>(*first - '0');
+			}
+			// 's' is the only presentation type, as for std::string_view
+			if (first != last and *first == 's') {
+				++first;
+			}
+			if (first != last and *first != '}') {
+				return std::nullopt;
+			}
+			return first;
+		}
+		// Writes the filtered characters to out, padded to spec.width. The view is only counted when a
+		// width is given.
+		template<typename OutputIt>
+		auto format_padded(const filtered_string_view& view, const format_spec& spec, OutputIt out) -> OutputIt {
+			auto size = spec.width == 0 ? 0 : view.size();
+			auto padding = size < spec.width ? spec.width - size : 0;
+			auto before = spec.align == '>' ? padding : spec.align == '^' ? padding / 2 : 0;
+			out = std::fill_n(out, before, spec.fill);
+			out = fsv::copy(view, out);
+			return std::fill_n(out, padding - before, spec.fill);
+		}
+	} // namespace detail
+
+	// Streaming 64-bit hash: bytes are mixed 8 at a time with a multiply-fold step, and a partial word is
+	// carried between calls to update(), so the digest depends only on the concatenated input and not on
+	// how it was split up. Not cryptographic.
+	class hasher {
+	 public:
+		hasher() noexcept = default;
+		explicit hasher(std::uint64_t seed) noexcept;
+
+		auto update(const char* data, std::size_t count) noexcept -> void;
+		auto digest() const noexcept -> std::uint64_t;
+
+	 private:
+		auto mix_word(const char* word) noexcept -> void;
+
+		std::uint64_t state_ = 0;
+		std::uint64_t length_ = 0;
+		std::array<char, 8> partial_ = {};
+		std::size_t partial_size_ = 0;
+	}; // hasher
+	auto hash_value(std::string_view str) noexcept -> std::size_t;
+	// equal to hash_value of the filtered characters, without materializing them
+	auto hash_value(const filtered_string_view& fsv) -> std::size_t;
+	// Hash and equality for heterogeneous lookup: an unordered container keyed by std::string with these
+	// functors can be probed with a filtered_string_view, or the other way round, without building a key.
+	struct transparent_hash {
+		using is_transparent = void;
+		auto operator()(std::string_view str) const noexcept -> std::size_t {
+			return hash_value(str);
+		}
+		auto operator()(const std::string& str) const noexcept -> std::size_t {
+			return hash_value(std::string_view(str));
+		}
+		auto operator()(const char* str) const noexcept -> std::size_t {
+			return hash_value(std::string_view(str));
+		}
+		auto operator()(const filtered_string_view& fsv) const -> std::size_t {
+			return hash_value(fsv);
+		}
+	};
+	using transparent_equal = std::equal_to<>;
 
 } // namespace fsv
 
+template<>
+struct std::hash<fsv::filtered_string_view> {
+	auto operator()(const fsv::filtered_string_view& fsv) const -> std::size_t {
+		return fsv::hash_value(fsv);
+	}
+};
+
+#if defined(__cpp_lib_format)
+// Supports [[fill]align][width][s] with a single-character fill; see fsv::detail::parse_format_spec.
+// This specialization has never been compiled by a toolchain this repo builds with: GCC 12 has no
+// <format>, so only the detail:: parsing and padding it forwards to are built and tested.
+template<>
+struct std::formatter<fsv::filtered_string_view> {
+	constexpr auto parse(std::format_parse_context& ctx) -> std::format_parse_context::iterator {
+		auto end = fsv::detail::parse_format_spec(ctx.begin(), ctx.end(), spec_);
+		if (not end) {
+			throw std::format_error("invalid format specification for filtered_string_view");
+		}
+		return *end;
+	}
+	template<typename FormatContext>
+	auto format(const fsv::filtered_string_view& view, FormatContext& ctx) const -> typename FormatContext::iterator {
+		return fsv::detail::format_padded(view, spec_, ctx.out());
+	}
+
+ private:
+	fsv::detail::format_spec spec_;
+};
+#endif
+
+// size() walks the whole view, so it must not be advertised as the O(1) ranges::size. The view is not
+// a borrowed_range: its iterators call the predicate owned by the view object.
+template<>
+inline constexpr bool std::ranges::disable_sized_range<fsv::filtered_string_view> = true;
+
 #endif // COMP6771_ASS2_FSV_H
@@ -2,6 +2,10 @@
 
 #include <catch2/catch.hpp>
 
+#include <iomanip>
+#include <unordered_map>
+#include <utility>
+
 TEST_CASE("Default Constructor") {
 	auto sv = fsv::filtered_string_view{};
 	std::cout << sv.size() << std::endl;
@@ -733,3 +737,534 @@ TEST_CASE("Iterator behavior and special method tests for filtered_string_view",
 	std::vector<char> chars(sub_s.begin(), sub_s.end());
 	CHECK(std::vector<char>({'h', 'e', 'l', 'l', 'o'}) == chars);
 }
+TEST_CASE("for_each_run visits maximal accepted runs in order", "[filtered_string_view][runs]") {
+	fsv::filtered_string_view sv{"ab--cd-e", [](const char& c) { return c != '-'; }};
+	std::vector<std::string> runs;
+	sv.for_each_run([&runs](const char* run, std::size_t count) { runs.emplace_back(run, count); });
+	CHECK(runs == std::vector<std::string>{"ab", "cd", "e"});
+
+	std::size_t visited = 0;
+	sv.for_each_run([&visited](const char*, std::size_t) {
+		++visited;
+		return false;
+	});
+	CHECK(visited == 1);
+}
+TEST_CASE("ADL copy bulk-copies accepted runs into contiguous and generic outputs", "[filtered_string_view][copy]") {
+	fsv::filtered_string_view sv{"h-e-l-l-o", [](const char& c) { return c != '-'; }};
+	using std::copy;
+
+	char buf[5] = {};
+	CHECK(copy(sv.begin(), sv.end(), buf) == buf + 5);
+	CHECK(std::string(buf, 5) == "hello");
+
+	std::vector<char> v(5);
+	CHECK(copy(sv.begin(), sv.end(), v.begin()) == v.end());
+	CHECK(v == std::vector<char>{'h', 'e', 'l', 'l', 'o'});
+
+	std::string s;
+	copy(std::next(sv.begin()), sv.end(), std::back_inserter(s));
+	CHECK(s == "ello");
+
+	std::string whole;
+	fsv::copy(sv, std::back_inserter(whole));
+	CHECK(whole == "hello");
+}
+TEST_CASE("byte_set membership and set operations", "[byte_set]") {
+	auto vowels = fsv::byte_set{"aeiou"};
+	CHECK(vowels('a'));
+	CHECK_FALSE(vowels('b'));
+	CHECK((~vowels)('b'));
+	CHECK_FALSE((~vowels)('e'));
+	auto high = fsv::byte_set{"\xff\x80"};
+	CHECK(high('\xff'));
+	CHECK_FALSE(high('\x7f'));
+	CHECK((vowels | high)('\x80'));
+	CHECK_FALSE((vowels & high)('a'));
+	auto digits = fsv::byte_set::from_predicate([](const char& c) { return std::isdigit(static_cast<unsigned char>(c)); });
+	CHECK(digits == fsv::byte_set{"0123456789"});
+	digits.erase('0');
+	CHECK_FALSE(digits('0'));
+}
+TEST_CASE("byte_set predicate skips long rejected runs in both directions", "[byte_set][iterators]") {
+	auto s = std::string(100, '.') + "a" + std::string(37, '.') + "b\xfe" + std::string(70, '.') + "c";
+	fsv::filtered_string_view sv{s, fsv::byte_set{"abc\xfe"}};
+	CHECK(std::string(sv.begin(), sv.end()) == "ab\xfe"
+	                                           "c");
+	CHECK(std::string(sv.rbegin(), sv.rend()) == "c\xfe"
+	                                             "ba");
+	CHECK(static_cast<std::string>(sv) == "ab\xfe"
+	                                      "c");
+
+	// same result as the equivalent opaque predicate
+	fsv::filtered_string_view opaque{s, [](const char& c) { return c != '.'; }};
+	CHECK(std::string(opaque.rbegin(), opaque.rend()) == std::string(sv.rbegin(), sv.rend()));
+}
+TEST_CASE("filtered_string_view models a bidirectional view", "[filtered_string_view][ranges]") {
+	static_assert(std::bidirectional_iterator<fsv::filtered_string_view::iterator>);
+	static_assert(std::ranges::bidirectional_range<fsv::filtered_string_view>);
+	static_assert(std::ranges::common_range<fsv::filtered_string_view>);
+	static_assert(std::ranges::view<fsv::filtered_string_view>);
+	static_assert(not std::ranges::sized_range<fsv::filtered_string_view>);
+
+	auto s = std::string{"a1b2c3d4"};
+	auto sv = fsv::filtered_string_view{s, [](const char& c) { return std::isalpha(static_cast<unsigned char>(c)); }};
+	CHECK(sv.front() == 'a');
+	CHECK(sv.back() == 'd');
+	CHECK(sv.begin().operator->() == s.data());
+
+	auto upper = sv | std::views::take(3)
+	             | std::views::transform([](char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+	auto taken = std::string();
+	std::ranges::copy(upper, std::back_inserter(taken));
+	CHECK(taken == "ABC");
+
+	auto reversed = sv | std::views::reverse;
+	CHECK(std::string(reversed.begin(), reversed.end()) == "dcba");
+}
+TEST_CASE("size_t indexing and substr overloads", "[filtered_string_view][index]") {
+	fsv::filtered_string_view sv{"a-b-c-d-e", [](const char& c) { return c != '-'; }};
+	CHECK(sv[std::size_t{3}] == 'd');
+	CHECK(sv.at(std::size_t{4}) == 'e');
+	CHECK_THROWS_AS(sv.at(std::size_t{5}), std::domain_error);
+	CHECK_THROWS_AS(sv.at(std::numeric_limits<std::size_t>::max()), std::domain_error);
+
+	CHECK(static_cast<std::string>(fsv::substr(sv, std::size_t{1}, std::size_t{3})) == "bcd");
+	CHECK(static_cast<std::string>(fsv::substr(sv, std::size_t{2})) == "cde");
+	CHECK(static_cast<std::string>(fsv::substr(sv, std::size_t{3}, std::numeric_limits<std::size_t>::max())) == "de");
+	CHECK(fsv::substr(sv, std::size_t{5}).size() == 0);
+
+	// the int overloads keep their clamping behaviour
+	CHECK(static_cast<std::string>(fsv::substr(sv, -3, -1)) == "abcde");
+	CHECK(sv.at(0) == 'a');
+}
+TEST_CASE("split and compose stay within non-null-terminated buffers", "[filtered_string_view][split]") {
+	const char buffer[] = {'a', ',', 'b', ',', 'c'};
+	auto sv = fsv::filtered_string_view{buffer, 3, fsv::filtered_string_view::default_predicate};
+	auto parts = fsv::split(sv, ",");
+	REQUIRE(parts.size() == 2);
+	CHECK(static_cast<std::string>(parts[0]) == "a");
+	CHECK(static_cast<std::string>(parts[1]) == "b");
+
+	auto composed = fsv::compose(sv, {[](const char& c) { return c != ','; }});
+	CHECK(static_cast<std::string>(composed) == "ab");
+}
+TEST_CASE("hash_value of a view equals the hash of its materialized string", "[fsv][hash]") {
+	auto str = std::string();
+	for (auto i = 0; i < 500; ++i) {
+		str += static_cast<char>('a' + i % 7);
+		if (i % 11 == 0) {
+			str += "--";
+		}
+	}
+	auto views = std::vector<fsv::filtered_string_view>{
+	    fsv::filtered_string_view(str),
+	    fsv::filtered_string_view(str, fsv::byte_set{"abc"}),
+	    fsv::filtered_string_view(str, [](const char& c) { return c != '-' and c != 'd'; }),
+	    fsv::filtered_string_view(str, [](const char&) { return false; }),
+	    fsv::filtered_string_view(),
+	};
+	for (const auto& sv : views) {
+		CHECK(fsv::hash_value(sv) == fsv::hash_value(std::string_view(static_cast<std::string>(sv))));
+		CHECK(std::hash<fsv::filtered_string_view>{}(sv) == fsv::hash_value(sv));
+	}
+	CHECK(fsv::hash_value(views[0]) != fsv::hash_value(views[1]));
+	CHECK(fsv::hash_value(std::string_view()) != fsv::hash_value(std::string_view("\0", 1)));
+}
+TEST_CASE("hasher digests do not depend on how the input is split", "[fsv][hash]") {
+	const auto str = std::string("the quick brown fox jumps over the lazy dog, twice over");
+	auto whole = fsv::hasher(42);
+	whole.update(str.data(), str.size());
+	for (std::size_t step = 1; step <= 13; ++step) {
+		auto pieces = fsv::hasher(42);
+		for (std::size_t pos = 0; pos < str.size(); pos += step) {
+			pieces.update(str.data() + pos, std::min(step, str.size() - pos));
+		}
+		CHECK(pieces.digest() == whole.digest());
+	}
+	auto other_seed = fsv::hasher(43);
+	other_seed.update(str.data(), str.size());
+	CHECK(other_seed.digest() != whole.digest());
+}
+TEST_CASE("filtered_string_view can key an unordered_map", "[fsv][hash]") {
+	auto counts = std::unordered_map<fsv::filtered_string_view, int>();
+	const auto rows = std::vector<std::string>{"a-b", "ab", "a--b", "ba"};
+	for (const auto& row : rows) {
+		++counts[fsv::filtered_string_view(row, [](const char& c) { return c != '-'; })];
+	}
+	CHECK(counts.size() == 2);
+	CHECK(counts[fsv::filtered_string_view("ab")] == 3);
+}
+TEST_CASE("filtered_string_view compares with strings without converting them", "[fsv][compare]") {
+	const auto text = std::string("a-b-c-d");
+	auto sv = fsv::filtered_string_view(text, fsv::byte_set{"abcd"});
+	CHECK(sv == "abcd");
+	CHECK("abcd" == sv);
+	CHECK(sv == std::string("abcd"));
+	CHECK(sv == std::string_view("abcd"));
+	CHECK(sv != "abc");
+	CHECK(sv != "abcde");
+	CHECK(sv != "abce");
+	CHECK(sv < "abce");
+	CHECK(sv > "abc");
+	CHECK(sv > "abbz");
+	CHECK("abcde" > sv);
+	CHECK((sv <=> std::string("abcd")) == std::strong_ordering::equal);
+	CHECK(fsv::filtered_string_view() == "");
+	CHECK(fsv::filtered_string_view() < "a");
+
+	auto opaque = fsv::filtered_string_view(text, [](const char& c) { return c != 'b'; });
+	CHECK(opaque == "a--c-d");
+	CHECK(opaque < "a-b");
+	// unsigned ordering, as std::string
+	CHECK(fsv::filtered_string_view("\xff") > "a");
+}
+TEST_CASE("transparent functors let string-keyed maps be probed with views", "[fsv][compare]") {
+	auto map = std::unordered_map<std::string, int, fsv::transparent_hash, fsv::transparent_equal>{{"apple", 1},
+	                                                                                                {"pear", 2}};
+	const auto field = std::string("p-e-a-r");
+	auto key = fsv::filtered_string_view(field, [](const char& c) { return c != '-'; });
+	auto it = map.find(key);
+	REQUIRE(it != map.end());
+	CHECK(it->second == 2);
+	CHECK(map.contains(fsv::filtered_string_view("apple")));
+	CHECK_FALSE(map.contains(fsv::filtered_string_view("plum")));
+	CHECK(map.count(std::string_view("apple")) == 1);
+	CHECK(fsv::transparent_hash{}(key) == fsv::transparent_hash{}(std::string("pear")));
+}
+namespace {
+	// forwards to new_delete_resource, recording the size of each allocation
+	class recording_resource : public std::pmr::memory_resource {
+	 public:
+		std::vector<std::size_t> sizes;
+
+	 private:
+		auto do_allocate(std::size_t bytes, std::size_t alignment) -> void* override {
+			sizes.push_back(bytes);
+			return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+		}
+		auto do_deallocate(void* p, std::size_t bytes, std::size_t alignment) -> void override {
+			std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+		}
+		auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+			return this == &other;
+		}
+	};
+} // namespace
+TEST_CASE("materialize_into allocates exactly the filtered length from the arena", "[fsv][materialize]") {
+	const auto text = std::string("x1y22z333--");
+	auto upstream = recording_resource();
+	auto digits = fsv::filtered_string_view(text, fsv::byte_set{"0123456789"});
+	auto opaque = fsv::filtered_string_view(text, [](const char& c) { return c == 'z' or c == '-'; });
+	auto none = fsv::filtered_string_view(text, [](const char&) { return false; });
+
+	auto a = digits.materialize_into(upstream);
+	auto b = opaque.materialize_into(upstream);
+	auto c = none.materialize_into(upstream);
+	CHECK(a == "122333");
+	CHECK(b == "z--");
+	CHECK(c.empty());
+	CHECK(upstream.sizes == std::vector<std::size_t>{6, 3});
+	upstream.deallocate(const_cast<char*>(a.data()), a.size(), alignof(char));
+	upstream.deallocate(const_cast<char*>(b.data()), b.size(), alignof(char));
+
+	// many small views, one upstream allocation
+	auto arena = std::pmr::monotonic_buffer_resource(1 << 16, &upstream);
+	auto views = std::vector<std::string_view>();
+	for (auto i = 0; i < 1000; ++i) {
+		views.push_back(digits.materialize_into(arena));
+	}
+	CHECK(upstream.sizes.size() == 3);
+	CHECK(views.front() == "122333");
+	CHECK(views.back() == "122333");
+	CHECK(views.front().data() != views.back().data());
+}
+TEST_CASE("assign_to and append_to reuse the caller's string", "[fsv][materialize]") {
+	const auto text = std::string("k=v; key=value; x=y");
+	auto no_space = fsv::filtered_string_view(text, ~fsv::byte_set{" "});
+	auto letters =
+	    fsv::filtered_string_view(text, [](const char& c) { return std::isalpha(static_cast<unsigned char>(c)); });
+
+	auto scratch = std::string();
+	scratch.reserve(64);
+	const auto* buffer = scratch.data();
+	no_space.assign_to(scratch);
+	CHECK(scratch == "k=v;key=value;x=y");
+	letters.assign_to(scratch);
+	CHECK(scratch == "kvkeyvaluexy");
+	letters.append_to(scratch);
+	CHECK(scratch == "kvkeyvaluexykvkeyvaluexy");
+	CHECK(scratch.data() == buffer);
+	fsv::filtered_string_view().assign_to(scratch);
+	CHECK(scratch.empty());
+}
+TEST_CASE("assign_to skips the capacity hint when the string already has room", "[fsv][materialize]") {
+	const auto text = std::string(4096, 'a') + std::string(4096, 'b');
+	auto calls = std::size_t{0};
+	auto sv = fsv::filtered_string_view(text, [&calls](const char& c) {
+		++calls;
+		return c == 'a';
+	});
+
+	sv.for_each_run([](const char*, std::size_t) {});
+	const auto copy_calls = std::exchange(calls, 0);
+
+	auto scratch = std::string();
+	scratch.reserve(text.size());
+	sv.assign_to(scratch);
+	CHECK(scratch == std::string(4096, 'a'));
+	CHECK(calls == copy_calls);
+}
+TEST_CASE("to_pmr_string allocates from the given resource", "[fsv][materialize]") {
+	auto upstream = recording_resource();
+	auto sv = fsv::filtered_string_view("a long enough string to skip the small string buffer", ~fsv::byte_set{" "});
+	auto str = sv.to_pmr_string(&upstream);
+	CHECK(str == "alongenoughstringtoskipthesmallstringbuffer");
+	CHECK(str.get_allocator().resource() == &upstream);
+	CHECK(upstream.sizes.size() == 1);
+	CHECK(fsv::filtered_string_view("abc").to_pmr_string() == "abc");
+}
+TEST_CASE("string conversion reserves close to the filtered size", "[fsv][materialize]") {
+	// one character in a hundred is kept
+	auto text = std::string(1 << 20, '.');
+	for (std::size_t i = 0; i < text.size(); i += 100) {
+		text[i] = 'k';
+	}
+	const auto kept = (text.size() + 99) / 100;
+
+	auto table = static_cast<std::string>(fsv::filtered_string_view(text, fsv::byte_set{"k"}));
+	CHECK(table.size() == kept);
+	CHECK(table.capacity() < 2 * kept);
+
+	auto opaque = static_cast<std::string>(fsv::filtered_string_view(text, [](const char& c) { return c == 'k'; }));
+	CHECK(opaque.size() == kept);
+	CHECK(opaque.capacity() < text.size() / 10);
+
+	// nearly everything kept: no reallocation on the way
+	auto dense = static_cast<std::string>(fsv::filtered_string_view(text, [](const char& c) { return c != 'k'; }));
+	CHECK(dense.size() == text.size() - kept);
+	CHECK(dense.capacity() == text.size());
+
+	// the samples miss a dense stretch, so the string has to grow past the estimate
+	auto skewed = std::string(text.size(), '.');
+	std::fill(skewed.begin() + 1000, skewed.begin() + 11000, 'k');
+	auto grown = static_cast<std::string>(fsv::filtered_string_view(skewed, [](const char& c) { return c == 'k'; }));
+	CHECK(grown == std::string(10000, 'k'));
+	CHECK(grown.capacity() >= grown.size());
+}
+TEST_CASE("copy_to fills a bounded buffer and resumes from a position", "[fsv][materialize]") {
+	const auto text = std::string("a1-b2-c3-d4-e5");
+	auto sv = fsv::filtered_string_view(text, ~fsv::byte_set{"-"});
+	auto buffer = std::array<char, 4>{};
+	auto out = std::string();
+	for (std::size_t pos = 0; pos < sv.size();) {
+		auto n = sv.copy_to(buffer.data(), buffer.size(), pos);
+		REQUIRE(n > 0);
+		out.append(buffer.data(), n);
+		pos += n;
+	}
+	CHECK(out == "a1b2c3d4e5");
+	CHECK(sv.copy_to(buffer.data(), buffer.size(), 8) == 2);
+	CHECK(std::string(buffer.data(), 2) == "e5");
+	CHECK(sv.copy_to(buffer.data(), buffer.size(), 10) == 0);
+	CHECK(sv.copy_to(buffer.data(), 0, 3) == 0);
+	CHECK_THROWS_AS(sv.copy_to(buffer.data(), 0, 11), std::out_of_range);
+	CHECK_THROWS_AS(sv.copy_to(buffer.data(), buffer.size(), 11), std::out_of_range);
+
+	auto opaque =
+	    fsv::filtered_string_view(text, [](const char& c) { return std::isdigit(static_cast<unsigned char>(c)); });
+	CHECK(opaque.copy_to(buffer.data(), 3, 1) == 3);
+	CHECK(std::string(buffer.data(), 3) == "234");
+}
+TEST_CASE("operator<< writes runs and still honours the field width", "[fsv][format]") {
+	auto sv = fsv::filtered_string_view("a-b-c", ~fsv::byte_set{"-"});
+	auto os = std::ostringstream();
+	os << sv << '|' << std::setw(5) << std::setfill('.') << sv << '|' << std::left << std::setw(4) << sv;
+	CHECK(os.str() == "abc|..abc|abc.");
+}
+#if defined(__cpp_lib_format)
+TEST_CASE("std::format writes views with fill, alignment and width", "[fsv][format]") {
+	auto sv = fsv::filtered_string_view("a-b-c", ~fsv::byte_set{"-"});
+	CHECK(std::format("{}", sv) == "abc");
+	CHECK(std::format("[{:6}]", sv) == "[abc   ]");
+	CHECK(std::format("[{:>6}]", sv) == "[   abc]");
+	CHECK(std::format("[{:*^7}]", sv) == "[**abc**]");
+	CHECK(std::format("[{:2}]", sv) == "[abc]");
+	CHECK(std::format("[{:s}]", sv) == "[abc]");
+	CHECK(std::format("[{:>8s}]", sv) == "[     abc]");
+	CHECK(std::format("{}|{}", fsv::filtered_string_view(), sv) == "|abc");
+	CHECK(std::format("<{}>", sv) == "<abc>");
+	CHECK(std::format("{}^{}", sv, sv) == "abc^abc");
+}
+#endif
+namespace {
+	// runs parse_format_spec over the text after "{:" and reports where it stopped
+	auto parse_spec(std::string_view spec, fsv::detail::format_spec& out) -> std::optional<std::size_t> {
+		auto end = fsv::detail::parse_format_spec(spec.begin(), spec.end(), out);
+		if (not end) {
+			return std::nullopt;
+		}
+		return static_cast<std::size_t>(*end - spec.begin());
+	}
+	auto format_with(std::string_view spec, const fsv::filtered_string_view& sv) -> std::string {
+		auto parsed = fsv::detail::format_spec();
+		REQUIRE(parse_spec(spec, parsed).has_value());
+		auto out = std::string();
+		fsv::detail::format_padded(sv, parsed, std::back_inserter(out));
+		return out;
+	}
+} // namespace
+TEST_CASE("format specifications are parsed up to the closing brace", "[fsv][format]") {
+	auto spec = fsv::detail::format_spec();
+	// an empty specification followed by literal text, as in "<{}>" and "{}^{}"
+	CHECK(parse_spec("}>", spec) == 0);
+	CHECK(parse_spec("}^{}", spec) == 0);
+	CHECK(spec.fill == ' ');
+	CHECK(spec.align == '<');
+	CHECK(parse_spec("", spec) == 0);
+
+	CHECK(parse_spec("*^7}rest", spec) == 3);
+	CHECK(spec.fill == '*');
+	CHECK(spec.align == '^');
+	CHECK(spec.width == 7);
+
+	spec = {};
+	CHECK(parse_spec(">12}", spec) == 3);
+	CHECK(spec.align == '>');
+	CHECK(spec.width == 12);
+
+	spec = {};
+	CHECK(parse_spec("s}", spec) == 1);
+	CHECK(spec.width == 0);
+	CHECK(parse_spec(">8s}", spec) == 3);
+	CHECK(spec.align == '>');
+	CHECK(spec.width == 8);
+	CHECK(parse_spec("s", spec) == 1);
+
+	spec = {};
+	CHECK_FALSE(parse_spec("ss}", spec).has_value());
+	CHECK_FALSE(parse_spec("8d}", spec).has_value());
+	CHECK_FALSE(parse_spec("{<5}", spec).has_value());
+	CHECK_FALSE(parse_spec("x}", spec).has_value());
+	CHECK_FALSE(parse_spec("5.2}", spec).has_value());
+	static_assert([] {
+		auto s = fsv::detail::format_spec();
+		auto text = std::string_view("-<4}");
+		return fsv::detail::parse_format_spec(text.begin(), text.end(), s) == text.begin() + 3 and s.fill == '-';
+	}());
+}
+TEST_CASE("formatted views are padded from the filtered size", "[fsv][format]") {
+	auto sv = fsv::filtered_string_view("a-b-c", ~fsv::byte_set{"-"});
+	CHECK(format_with("}", sv) == "abc");
+	CHECK(format_with("6}", sv) == "abc   ");
+	CHECK(format_with(">6}", sv) == "   abc");
+	CHECK(format_with("*^7}", sv) == "**abc**");
+	CHECK(format_with("*^6}", sv) == "*abc**");
+	CHECK(format_with("2}", sv) == "abc");
+	CHECK(format_with("}}", sv) == "abc");
+	CHECK(format_with(">8s}", sv) == "     abc");
+	CHECK(format_with(".>3}", fsv::filtered_string_view()) == "...");
+}
+TEST_CASE("search functions agree with std::string on the filtered sequence", "[fsv][search]") {
+	auto text = std::string();
+	for (auto i = 0; i < 3000; ++i) {
+		text += static_cast<char>("abcab-c.d"[(i * 7 + i / 13) % 9]);
+	}
+	auto views = std::vector<fsv::filtered_string_view>{
+	    fsv::filtered_string_view(text),
+	    fsv::filtered_string_view(text, ~fsv::byte_set{"-."}),
+	    fsv::filtered_string_view(text, [](const char& c) { return c != 'b' and c != '.'; }),
+	};
+	const auto needles = std::vector<std::string>{"a", "ab", "cab", "ca-c", "dab", "zz", "", "abcabcabcabcabcabcabc"};
+	const auto positions = std::vector<std::size_t>{0, 1, 17, 1000, 2500, 2999, 5000, fsv::filtered_string_view::npos};
+	for (const auto& sv : views) {
+		auto str = static_cast<std::string>(sv);
+		for (auto pos : positions) {
+			for (auto c : std::string("abd-.z")) {
+				CHECK(sv.find(c, pos) == str.find(c, pos));
+				CHECK(sv.rfind(c, pos) == str.rfind(c, pos));
+			}
+			for (const auto& needle : needles) {
+				CHECK(sv.find(needle, pos) == str.find(needle, pos));
+				CHECK(sv.rfind(needle, pos) == str.rfind(needle, pos));
+			}
+			for (auto chars : {"ab", "d", "abc", "abcd-.", "", "z"}) {
+				CHECK(sv.find_first_of(chars, pos) == str.find_first_of(chars, pos));
+				CHECK(sv.find_first_not_of(chars, pos) == str.find_first_not_of(chars, pos));
+			}
+		}
+		for (auto c : std::string("abd-.z")) {
+			CHECK(sv.count(c) == static_cast<std::size_t>(std::ranges::count(str, c)));
+			CHECK(sv.contains(c) == (str.find(c) != std::string::npos));
+		}
+	}
+}
+TEST_CASE("search functions accept filtered_string_view needles", "[fsv][search]") {
+	auto sv = fsv::filtered_string_view("x-y-z-x-y", ~fsv::byte_set{"-"});
+	auto needle = fsv::filtered_string_view("x.y", ~fsv::byte_set{"."});
+	CHECK(sv.find(needle) == 0);
+	CHECK(sv.find(needle, 1) == 3);
+	CHECK(sv.rfind(needle) == 3);
+	CHECK(sv.find("zx") == 2);
+	CHECK(sv.contains("yzx"));
+	CHECK_FALSE(sv.contains("x-y"));
+	CHECK(sv.find(std::string("yx")) == fsv::filtered_string_view::npos);
+	CHECK(fsv::filtered_string_view().find('a') == fsv::filtered_string_view::npos);
+	CHECK(fsv::filtered_string_view().rfind("") == 0);
+}
+TEST_CASE("starts_with and ends_with check the filtered sequence", "[fsv][search]") {
+	const auto url = std::string("h-t-t-p-s://example.org/index.h-t-m-l");
+	auto table = fsv::filtered_string_view(url, ~fsv::byte_set{"-"});
+	auto opaque = fsv::filtered_string_view(url, [](const char& c) { return c != '-'; });
+	for (const auto& sv : {table, opaque}) {
+		CHECK(sv.starts_with("https://"));
+		CHECK(sv.starts_with('h'));
+		CHECK(sv.starts_with(""));
+		CHECK_FALSE(sv.starts_with("http:"));
+		CHECK_FALSE(sv.starts_with("h-t"));
+		CHECK(sv.ends_with(".html"));
+		CHECK(sv.ends_with('l'));
+		CHECK(sv.ends_with(""));
+		CHECK_FALSE(sv.ends_with(".htm"));
+		CHECK_FALSE(sv.ends_with("t-m-l"));
+		CHECK(sv.ends_with(static_cast<std::string>(sv)));
+		CHECK_FALSE(sv.starts_with("x" + static_cast<std::string>(sv)));
+		CHECK_FALSE(sv.ends_with("x" + static_cast<std::string>(sv)));
+	}
+	auto empty = fsv::filtered_string_view("---", ~fsv::byte_set{"-"});
+	CHECK(empty.starts_with(""));
+	CHECK(empty.ends_with(""));
+	CHECK_FALSE(empty.starts_with('-'));
+	CHECK_FALSE(empty.ends_with('-'));
+	CHECK_FALSE(fsv::filtered_string_view().ends_with("a"));
+}
+TEST_CASE("starts_with and ends_with stop after the prefix or suffix", "[fsv][search]") {
+	auto calls = std::size_t{0};
+	auto text = std::string(10000, 'a');
+	auto sv = fsv::filtered_string_view(text, [&calls](const char&) {
+		++calls;
+		return true;
+	});
+	CHECK(sv.starts_with("aaa"));
+	CHECK(calls <= 3);
+	calls = 0;
+	CHECK_FALSE(sv.ends_with("baa"));
+	CHECK(calls <= 3);
+}
+TEST_CASE("indexing and substr accept any integer type", "[fsv][compat]") {
+	auto sv = fsv::filtered_string_view("a-b-c-d", ~fsv::byte_set{"-"});
+	CHECK(sv[1] == 'b');
+	CHECK(sv[1u] == 'b');
+	CHECK(sv[1L] == 'b');
+	CHECK(sv[std::size_t{2}] == 'c');
+	CHECK(sv[-1] == 'a');
+	CHECK(sv.at(1u) == 'b');
+	CHECK(sv.at(std::int64_t{3}) == 'd');
+	CHECK_THROWS_AS(sv.at(-1L), std::domain_error);
+	CHECK_THROWS_AS(sv.at(4u), std::domain_error);
+	CHECK(static_cast<std::string>(fsv::substr(sv, 1u, 2u)) == "bc");
+	CHECK(static_cast<std::string>(fsv::substr(sv, std::size_t{1}, 2)) == "bc");
+	CHECK(static_cast<std::string>(fsv::substr(sv, 2L)) == "cd");
+	CHECK(static_cast<std::string>(fsv::substr(sv, -3, -1)) == "abcd");
+	CHECK(static_cast<std::string>(fsv::substr(sv)) == "abcd");
+}
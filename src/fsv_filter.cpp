@@ -0,0 +1,291 @@
+// fsv_filter: filter stdin or files through a filtered_string_view, like `tr -d` on steroids.
+//
+// usage: fsv_filter [-c CLASS]... [-s SET]... [-d] [-t DELIM] [-p] [-q] [FILE]...
+//
+// Statistics (throughput, predicate calls, allocations) are printed to stderr at exit unless -q is given.
+
+#include "./filter_io.h"
+#include "./filtered_string_view.h"
+#include "./mapped_file.h"
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+	std::atomic<std::size_t> allocations = 0;
+	std::atomic<std::size_t> predicate_calls = 0;
+
+	struct options {
+		fsv::byte_set selected;
+		bool delete_selected = false;
+		std::optional<std::string> delimiter;
+		bool count_calls = false;
+		bool quiet = false;
+		std::vector<std::string> files;
+	};
+	struct totals {
+		std::size_t bytes_in = 0;
+		std::size_t bytes_out = 0;
+	};
+
+	auto usage() -> int {
+		std::cerr << "usage: fsv_filter [-c CLASS]... [-s SET]... [-d] [-t DELIM] [-p] [-q] [FILE]...\n"
+		             "  -c CLASS  select a character class: alnum alpha blank cntrl digit graph\n"
+		             "            lower print punct space upper xdigit\n"
+		             "  -s SET    select the bytes in SET; a-z ranges and \\n \\t \\r \\\\ \\xHH escapes\n"
+		             "  -d        delete the selected bytes instead of keeping them\n"
+		             "  -t DELIM  split the input on DELIM and print one filtered piece per line\n"
+		             "  -p        call the predicate through an opaque, counted function\n"
+		             "  -q        do not print statistics\n";
+		return 2;
+	}
+	auto character_class(std::string_view name) -> std::optional<fsv::byte_set> {
+		// lambdas rather than &std::isalnum and friends: taking the address of a standard library function
+		// is unspecified
+		static const auto classes = std::vector<std::pair<std::string_view, bool (*)(unsigned char)>>{
+		    {"alnum", [](unsigned char c) { return std::isalnum(c) != 0; }},
+		    {"alpha", [](unsigned char c) { return std::isalpha(c) != 0; }},
+		    {"blank", [](unsigned char c) { return std::isblank(c) != 0; }},
+		    {"cntrl", [](unsigned char c) { return std::iscntrl(c) != 0; }},
+		    {"digit", [](unsigned char c) { return std::isdigit(c) != 0; }},
+		    {"graph", [](unsigned char c) { return std::isgraph(c) != 0; }},
+		    {"lower", [](unsigned char c) { return std::islower(c) != 0; }},
+		    {"print", [](unsigned char c) { return std::isprint(c) != 0; }},
+		    {"punct", [](unsigned char c) { return std::ispunct(c) != 0; }},
+		    {"space", [](unsigned char c) { return std::isspace(c) != 0; }},
+		    {"upper", [](unsigned char c) { return std::isupper(c) != 0; }},
+		    {"xdigit", [](unsigned char c) { return std::isxdigit(c) != 0; }},
+		};
+		for (const auto& [class_name, is_member] : classes) {
+			if (class_name == name) {
+				return fsv::byte_set::from_predicate(
+				    [is_member](const char& c) { return is_member(static_cast<unsigned char>(c)); });
+			}
+		}
+		return std::nullopt;
+	}
+	auto hex_digit(char c) -> std::optional<unsigned> {
+		if (c >= '0' and c <= '9') {
+			return static_cast<unsigned>(c - '0');
+		}
+		if (c >= 'a' and c <= 'f') {
+			return static_cast<unsigned>(c - 'a' + 10);
+		}
+		if (c >= 'A' and c <= 'F') {
+			return static_cast<unsigned>(c - 'A' + 10);
+		}
+		return std::nullopt;
+	}
+	// next (possibly escaped) character of spec, advancing i; nullopt for a malformed \x escape
+	auto next_set_char(std::string_view spec, std::size_t& i) -> std::optional<char> {
+		auto c = spec[i++];
+		if (c != '\\' or i == spec.size()) {
+			return c;
+		}
+		switch (auto escaped = spec[i++]) {
+		case 'n': return '\n';
+		case 't': return '\t';
+		case 'r': return '\r';
+		case '0': return '\0';
+		case 'x': {
+			auto high = i < spec.size() ? hex_digit(spec[i]) : std::nullopt;
+			auto low = i + 1 < spec.size() ? hex_digit(spec[i + 1]) : std::nullopt;
+			if (not high or not low) {
+				return std::nullopt;
+			}
+			i += 2;
+			return static_cast<char>(*high * 16 + *low);
+		}
+		default: return escaped;
+		}
+	}
+	auto parse_set(std::string_view spec) -> std::optional<fsv::byte_set> {
+		auto set = fsv::byte_set();
+		for (std::size_t i = 0; i < spec.size();) {
+			auto first = next_set_char(spec, i);
+			auto last = first;
+			if (first and i + 1 < spec.size() and spec[i] == '-') {
+				++i;
+				last = next_set_char(spec, i);
+			}
+			// a reversed range such as z-a selects nothing, which is never what was meant
+			if (not first or not last or static_cast<unsigned char>(*first) > static_cast<unsigned char>(*last)) {
+				return std::nullopt;
+			}
+			for (auto b = static_cast<unsigned>(static_cast<unsigned char>(*first));
+			     b <= static_cast<unsigned char>(*last);
+			     ++b) {
+				set.insert(static_cast<char>(b));
+			}
+		}
+		return set;
+	}
+	auto make_predicate(const options& opts) -> fsv::filter {
+		auto set = opts.delete_selected ? ~opts.selected : opts.selected;
+		if (opts.count_calls) {
+			return [set](const char& c) {
+				predicate_calls.fetch_add(1, std::memory_order_relaxed);
+				return set(c);
+			};
+		}
+		return set;
+	}
+	auto write_view(const fsv::filtered_string_view& view, totals& total) -> void {
+		view.for_each_run([&total](const char* run, std::size_t count) {
+			std::cout.write(run, static_cast<std::streamsize>(count));
+			total.bytes_out += count;
+		});
+	}
+	auto split_input(const fsv::filtered_string_view& input, const options& opts, totals& total) -> void {
+		total.bytes_in += input.underlying_size();
+		for (const auto& piece : fsv::split(input, *opts.delimiter)) {
+			write_view(piece, total);
+			std::cout.put('\n');
+		}
+	}
+	// input that cannot be mapped is read in blocks, or whole when it has to be split
+	auto filter_stream(std::istream& in, const fsv::filter& predicate, const options& opts, totals& total) -> void {
+		if (opts.delimiter) {
+			auto input = std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			split_input(fsv::filtered_string_view(input.data(), input.size(), predicate), opts, total);
+			return;
+		}
+		auto block = std::vector<char>(fsv::default_block_size);
+		while (in.read(block.data(), static_cast<std::streamsize>(block.size())) or in.gcount() > 0) {
+			auto count = static_cast<std::size_t>(in.gcount());
+			total.bytes_in += count;
+			write_view(fsv::filtered_string_view(block.data(), count, predicate), total);
+		}
+	}
+	auto run(const options& opts, totals& total) -> void {
+		auto predicate = make_predicate(opts);
+		if (opts.files.empty()) {
+			filter_stream(std::cin, predicate, opts, total);
+			return;
+		}
+		for (const auto& path : opts.files) {
+			auto file = std::optional<fsv::mapped_file>();
+			try {
+				file.emplace(path);
+			} catch (const std::system_error& e) {
+				// pipes, devices and /proc files are streamed instead
+				if (e.code() != std::errc::invalid_argument) {
+					throw;
+				}
+			}
+			if (not file) {
+				auto in = std::ifstream(path, std::ios::binary);
+				if (not in) {
+					throw std::runtime_error("cannot read " + path);
+				}
+				filter_stream(in, predicate, opts, total);
+			}
+			else if (opts.delimiter) {
+				split_input(file->view(predicate), opts, total);
+			}
+			else {
+				total.bytes_in += file->size();
+				write_view(file->view(predicate), total);
+			}
+		}
+	}
+} // namespace
+
+// Counting replacements for the global allocation functions. GCC cannot see that these new/delete pairs
+// match once they are inlined into their callers.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+auto operator new(std::size_t size) -> void* {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (auto p = std::malloc(size == 0 ? 1 : size)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+auto operator delete(void* p) noexcept -> void {
+	std::free(p);
+}
+auto operator delete(void* p, std::size_t) noexcept -> void {
+	std::free(p);
+}
+#pragma GCC diagnostic pop
+
+auto main(int argc, char* argv[]) -> int {
+	std::ios::sync_with_stdio(false);
+	auto opts = options();
+	auto have_selection = false;
+	for (int opt; (opt = ::getopt(argc, argv, "c:s:dt:pq")) != -1;) {
+		switch (opt) {
+		case 'c': {
+			auto set = character_class(optarg);
+			if (not set) {
+				std::cerr << "fsv_filter: unknown character class '" << optarg << "'\n";
+				return usage();
+			}
+			opts.selected = opts.selected | *set;
+			have_selection = true;
+			break;
+		}
+		case 's': {
+			auto set = parse_set(optarg);
+			if (not set) {
+				std::cerr << "fsv_filter: invalid set '" << optarg << "' (malformed \\x escape or reversed range)\n";
+				return usage();
+			}
+			opts.selected = opts.selected | *set;
+			have_selection = true;
+			break;
+		}
+		case 'd': opts.delete_selected = true; break;
+		case 't': opts.delimiter = optarg; break;
+		case 'p': opts.count_calls = true; break;
+		case 'q': opts.quiet = true; break;
+		default: return usage();
+		}
+	}
+	if (not have_selection) {
+		return usage();
+	}
+	for (auto i = optind; i < argc; ++i) {
+		opts.files.emplace_back(argv[i]);
+	}
+
+	auto total = totals();
+	auto start = std::chrono::steady_clock::now();
+	try {
+		run(opts, total);
+		std::cout.flush();
+	} catch (const std::exception& e) {
+		std::cout.flush();
+		std::cerr << "fsv_filter: " << e.what() << '\n';
+		return 1;
+	}
+	auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (not opts.quiet) {
+		auto megabytes = static_cast<double>(total.bytes_in) / 1e6;
+		std::cerr << "fsv_filter: " << total.bytes_in << " bytes in, " << total.bytes_out << " bytes out, " << seconds
+		          << " s, " << (seconds > 0 ? megabytes / seconds : 0.0) << " MB/s\n"
+		          << "fsv_filter: predicate calls: ";
+		if (opts.count_calls) {
+			std::cerr << predicate_calls.load() << '\n';
+		}
+		else {
+			std::cerr << "n/a (byte_set table lookups)\n";
+		}
+		std::cerr << "fsv_filter: allocations: " << allocations.load() << '\n';
+	}
+	return 0;
+}
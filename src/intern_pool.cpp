@@ -0,0 +1,91 @@
+#include "./intern_pool.h"
+
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+fsv::intern_pool::intern_pool()
+: arena_(std::make_unique<std::pmr::monotonic_buffer_resource>()) {}
+fsv::intern_pool::intern_pool(intern_pool&& other) noexcept
+: arena_(std::move(other.arena_))
+, index_(std::move(other.index_))
+, strings_(std::move(other.strings_))
+, bytes_(std::exchange(other.bytes_, 0)) {
+	other.index_.clear();
+	other.strings_.clear();
+}
+auto fsv::intern_pool::operator=(intern_pool&& other) noexcept -> intern_pool& {
+	if (this != &other) {
+		arena_ = std::move(other.arena_);
+		index_ = std::move(other.index_);
+		strings_ = std::move(other.strings_);
+		bytes_ = std::exchange(other.bytes_, 0);
+		other.index_.clear();
+		other.strings_.clear();
+	}
+	return *this;
+}
+auto fsv::intern_pool::intern(const filtered_string_view& fsv) -> handle {
+	if (auto found = index_.find(fsv); found != index_.end()) {
+		return found->second;
+	}
+	return add(fsv.materialize_into(arena()));
+}
+auto fsv::intern_pool::intern(std::string_view str) -> handle {
+	if (auto found = index_.find(str); found != index_.end()) {
+		return found->second;
+	}
+	if (str.empty()) {
+		return add(std::string_view());
+	}
+	auto* chars = static_cast<char*>(arena().allocate(str.size(), alignof(char)));
+	std::copy(str.begin(), str.end(), chars);
+	return add(std::string_view(chars, str.size()));
+}
+auto fsv::intern_pool::find(const filtered_string_view& fsv) const -> std::optional<handle> {
+	if (auto found = index_.find(fsv); found != index_.end()) {
+		return found->second;
+	}
+	return std::nullopt;
+}
+auto fsv::intern_pool::find(std::string_view str) const -> std::optional<handle> {
+	if (auto found = index_.find(str); found != index_.end()) {
+		return found->second;
+	}
+	return std::nullopt;
+}
+auto fsv::intern_pool::operator[](handle h) const noexcept -> std::string_view {
+	return strings_[h];
+}
+auto fsv::intern_pool::at(handle h) const -> std::string_view {
+	if (h >= strings_.size()) {
+		throw std::out_of_range("intern_pool::at(" + std::to_string(h) + "): invalid handle");
+	}
+	return strings_[h];
+}
+auto fsv::intern_pool::size() const noexcept -> std::size_t {
+	return strings_.size();
+}
+auto fsv::intern_pool::empty() const noexcept -> bool {
+	return strings_.empty();
+}
+auto fsv::intern_pool::bytes() const noexcept -> std::size_t {
+	return bytes_;
+}
+auto fsv::intern_pool::arena() -> std::pmr::monotonic_buffer_resource& {
+	if (not arena_) {
+		arena_ = std::make_unique<std::pmr::monotonic_buffer_resource>();
+	}
+	return *arena_;
+}
+auto fsv::intern_pool::add(std::string_view stored) -> handle {
+	if (strings_.size() > std::numeric_limits<handle>::max()) {
+		throw std::length_error("intern_pool: out of handles");
+	}
+	auto h = static_cast<handle>(strings_.size());
+	strings_.push_back(stored);
+	index_.emplace(stored, h);
+	bytes_ += stored.size();
+	return h;
+}
@@ -0,0 +1,59 @@
+#ifndef COMP6771_ASS2_INTERN_POOL_H
+#define COMP6771_ASS2_INTERN_POOL_H
+
+#include "./filtered_string_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace fsv {
+	// Stores each distinct filtered string once, in an arena, and names it with a dense 32-bit handle.
+	// Views are looked up by hashing their accepted runs, so interning a string that is already present
+	// allocates nothing. Handles and the string_views returned for them stay valid for the lifetime of
+	// the pool, including across moves. A moved-from pool is empty and can be used again.
+	class intern_pool {
+	 public:
+		using handle = std::uint32_t;
+
+		intern_pool();
+		intern_pool(const intern_pool& other) = delete;
+		intern_pool(intern_pool&& other) noexcept;
+		~intern_pool() = default;
+
+		auto operator=(const intern_pool& other) -> intern_pool& = delete;
+		auto operator=(intern_pool&& other) noexcept -> intern_pool&;
+
+		// the handle of the filtered content of fsv, adding it if it is new
+		auto intern(const filtered_string_view& fsv) -> handle;
+		auto intern(std::string_view str) -> handle;
+		// the handle of an already interned string, without adding it
+		auto find(const filtered_string_view& fsv) const -> std::optional<handle>;
+		auto find(std::string_view str) const -> std::optional<handle>;
+
+		auto operator[](handle h) const noexcept -> std::string_view;
+		// throws std::out_of_range for a handle this pool did not return
+		auto at(handle h) const -> std::string_view;
+		auto size() const noexcept -> std::size_t;
+		auto empty() const noexcept -> bool;
+		// characters stored in the arena
+		auto bytes() const noexcept -> std::size_t;
+
+	 private:
+		// the arena, made again on first use after this pool was moved from
+		auto arena() -> std::pmr::monotonic_buffer_resource&;
+		auto add(std::string_view stored) -> handle;
+
+		std::unique_ptr<std::pmr::monotonic_buffer_resource> arena_;
+		std::unordered_map<std::string_view, handle, transparent_hash, transparent_equal> index_;
+		std::vector<std::string_view> strings_;
+		std::size_t bytes_ = 0;
+	}; // intern_pool
+} // namespace fsv
+
+#endif // COMP6771_ASS2_INTERN_POOL_H
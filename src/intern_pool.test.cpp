@@ -0,0 +1,79 @@
+#include "./intern_pool.h"
+
+#include <catch2/catch.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("intern_pool gives each distinct filtered string one handle", "[intern_pool]") {
+	auto pool = fsv::intern_pool();
+	const auto records =
+	    std::vector<std::string>{"host=a.example", "host=b.example", "host=a.example", "HOST=a.example"};
+	auto after_eq = [](const std::string& record) {
+		return fsv::substr(fsv::filtered_string_view(record), std::size_t{5});
+	};
+	auto a = pool.intern(after_eq(records[0]));
+	auto b = pool.intern(after_eq(records[1]));
+	CHECK(a != b);
+	CHECK(pool.intern(after_eq(records[2])) == a);
+	CHECK(pool.intern(after_eq(records[3])) == a);
+	CHECK(pool.intern(std::string_view("a.example")) == a);
+	CHECK(pool.size() == 2);
+	CHECK(pool.bytes() == 18);
+	CHECK(pool[a] == "a.example");
+	CHECK(pool.at(b) == "b.example");
+	CHECK(pool[a].data() != records[0].data() + 5);
+	CHECK_THROWS_AS(pool.at(7), std::out_of_range);
+}
+TEST_CASE("intern_pool hashes the filtered content", "[intern_pool]") {
+	auto pool = fsv::intern_pool();
+	auto no_dash = fsv::byte_set{"-"};
+	const auto a = std::string("2-0-0");
+	const auto b = std::string("20--0");
+	auto h = pool.intern(fsv::filtered_string_view(a, ~no_dash));
+	CHECK(pool.intern(fsv::filtered_string_view(b, [](const char& c) { return c != '-'; })) == h);
+	CHECK(pool[h] == "200");
+	CHECK(pool.find(fsv::filtered_string_view("200")) == h);
+	CHECK(pool.find(std::string_view("404")) == std::nullopt);
+	CHECK(pool.size() == 1);
+
+	auto empty = pool.intern(fsv::filtered_string_view(a, [](const char&) { return false; }));
+	CHECK(pool[empty].empty());
+	CHECK(pool.intern(std::string_view()) == empty);
+}
+TEST_CASE("intern_pool string_views stay valid as the pool grows and moves", "[intern_pool]") {
+	auto pool = fsv::intern_pool();
+	auto first = pool.intern(std::string_view("first"));
+	auto stored = pool[first];
+	for (auto i = 0; i < 10000; ++i) {
+		pool.intern(std::string_view(std::to_string(i)));
+	}
+	auto moved = std::move(pool);
+	CHECK(moved.size() == 10001);
+	CHECK(moved[first].data() == stored.data());
+	CHECK(moved[first] == "first");
+	CHECK(moved.find(std::string_view("9999")).has_value());
+}
+TEST_CASE("a moved-from intern_pool is empty and can be reused", "[intern_pool]") {
+	auto pool = fsv::intern_pool();
+	auto a = pool.intern(std::string_view("a.example"));
+	auto moved = fsv::intern_pool(std::move(pool));
+	CHECK(pool.empty());
+	CHECK(pool.bytes() == 0);
+	CHECK(pool.find(std::string_view("a.example")) == std::nullopt);
+
+	auto b = pool.intern(fsv::filtered_string_view("b.example"));
+	CHECK(b == 0);
+	CHECK(pool.intern(std::string_view("c.example")) == 1);
+	CHECK(pool[b] == "b.example");
+	CHECK(pool.bytes() == 18);
+	CHECK(moved[a] == "a.example");
+
+	moved = std::move(pool);
+	CHECK(pool.empty());
+	CHECK(pool.intern(std::string_view("d.example")) == 0);
+	CHECK(moved.size() == 2);
+	CHECK(moved[1] == "c.example");
+}
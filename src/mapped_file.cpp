@@ -0,0 +1,87 @@
+#include "./mapped_file.h"
+
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	auto system_error(const std::string& what) -> std::system_error {
+		return std::system_error(errno, std::generic_category(), what);
+	}
+} // namespace
+
+fsv::mapped_file::mapped_file(const std::string& path)
+: data_(nullptr)
+, size_(0) {
+	// O_NONBLOCK so that opening a FIFO with no writer fails below instead of hanging here
+	auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+	if (fd < 0) {
+		throw system_error("mapped_file: cannot open " + path);
+	}
+	struct stat info = {};
+	if (::fstat(fd, &info) != 0) {
+		auto error = system_error("mapped_file: cannot stat " + path);
+		::close(fd);
+		throw error;
+	}
+	// Pipes, devices and the like report no usable size and cannot be mapped. So do files such as those
+	// under /proc, which claim to be empty but produce data when read.
+	auto probe = char();
+	if (!S_ISREG(info.st_mode) or (info.st_size == 0 and ::read(fd, &probe, 1) > 0)) {
+		::close(fd);
+		throw std::system_error(std::make_error_code(std::errc::invalid_argument),
+		                        "mapped_file: " + path + " is not a regular file");
+	}
+	size_ = static_cast<std::size_t>(info.st_size);
+	// mmap rejects empty mappings; an empty file is just an empty view
+	if (size_ != 0) {
+		auto addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (addr == MAP_FAILED) {
+			auto error = system_error("mapped_file: cannot map " + path);
+			::close(fd);
+			throw error;
+		}
+		// purely advisory, so failures are ignored
+		::madvise(addr, size_, MADV_SEQUENTIAL);
+		::madvise(addr, size_, MADV_WILLNEED);
+		data_ = static_cast<const char*>(addr);
+	}
+	// the mapping keeps the file contents alive on its own
+	::close(fd);
+}
+fsv::mapped_file::mapped_file(mapped_file&& other) noexcept
+: data_(std::exchange(other.data_, nullptr))
+, size_(std::exchange(other.size_, 0)) {}
+fsv::mapped_file::~mapped_file() {
+	unmap();
+}
+auto fsv::mapped_file::operator=(mapped_file&& other) noexcept -> mapped_file& {
+	if (this != &other) {
+		unmap();
+		data_ = std::exchange(other.data_, nullptr);
+		size_ = std::exchange(other.size_, 0);
+	}
+	return *this;
+}
+auto fsv::mapped_file::data() const noexcept -> const char* {
+	return data_;
+}
+auto fsv::mapped_file::size() const noexcept -> std::size_t {
+	return size_;
+}
+auto fsv::mapped_file::view() const -> filtered_string_view {
+	return filtered_string_view(data_, size_, filtered_string_view::default_predicate);
+}
+auto fsv::mapped_file::view(filter predicate) const -> filtered_string_view {
+	return filtered_string_view(data_, size_, std::move(predicate));
+}
+auto fsv::mapped_file::unmap() noexcept -> void {
+	if (data_ != nullptr) {
+		::munmap(const_cast<char*>(data_), size_);
+	}
+}
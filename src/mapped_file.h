@@ -0,0 +1,39 @@
+#ifndef COMP6771_ASS2_MAPPED_FILE_H
+#define COMP6771_ASS2_MAPPED_FILE_H
+
+#include "./filtered_string_view.h"
+
+#include <cstddef>
+#include <string>
+
+namespace fsv {
+	// Read-only memory mapping of a whole file. The views it hands out point straight into the mapping,
+	// which is not null-terminated, and stay valid for as long as the mapped_file is alive.
+	class mapped_file {
+	 public:
+		// maps the file and advises the kernel that it will be read sequentially soon;
+		// throws std::system_error if the file cannot be opened or mapped, including when it is not a
+		// regular file (pipes, devices, /proc files); read those as a stream instead
+		explicit mapped_file(const std::string& path);
+		mapped_file(const mapped_file& other) = delete;
+		mapped_file(mapped_file&& other) noexcept;
+		~mapped_file();
+
+		auto operator=(const mapped_file& other) -> mapped_file& = delete;
+		auto operator=(mapped_file&& other) noexcept -> mapped_file&;
+
+		auto data() const noexcept -> const char*;
+		auto size() const noexcept -> std::size_t;
+
+		auto view() const -> filtered_string_view;
+		auto view(filter predicate) const -> filtered_string_view;
+
+	 private:
+		auto unmap() noexcept -> void;
+
+		const char* data_;
+		std::size_t size_;
+	}; // mapped_file
+} // namespace fsv
+
+#endif // COMP6771_ASS2_MAPPED_FILE_H
@@ -0,0 +1,63 @@
+#include "./mapped_file.h"
+
+#include <catch2/catch.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include <sys/stat.h>
+
+namespace {
+	auto write_temp_file(const std::string& name, const std::string& contents) -> std::string {
+		auto path = (std::filesystem::temp_directory_path() / name).string();
+		std::ofstream(path, std::ios::binary) << contents;
+		return path;
+	}
+} // namespace
+
+TEST_CASE("mapped_file exposes the file contents as views", "[mapped_file]") {
+	auto path = write_temp_file("fsv_mapped_file_test.txt", "a1,b2,c3");
+	auto file = fsv::mapped_file(path);
+	CHECK(file.size() == 8);
+	CHECK(static_cast<std::string>(file.view()) == "a1,b2,c3");
+
+	auto letters = file.view([](const char& c) { return std::isalpha(static_cast<unsigned char>(c)); });
+	CHECK(letters.data() == file.data());
+	CHECK(static_cast<std::string>(letters) == "abc");
+
+	auto parts = fsv::split(file.view(), ",");
+	REQUIRE(parts.size() == 3);
+	CHECK(static_cast<std::string>(parts[2]) == "c3");
+	std::filesystem::remove(path);
+}
+TEST_CASE("mapped_file handles empty files and moves", "[mapped_file]") {
+	auto path = write_temp_file("fsv_mapped_file_empty.txt", "");
+	auto empty = fsv::mapped_file(path);
+	CHECK(empty.size() == 0);
+	CHECK(empty.view().empty());
+
+	auto other_path = write_temp_file("fsv_mapped_file_move.txt", "xyz");
+	auto source = fsv::mapped_file(other_path);
+	auto target = std::move(source);
+	CHECK(source.data() == nullptr);
+	CHECK(static_cast<std::string>(target.view()) == "xyz");
+	empty = std::move(target);
+	CHECK(static_cast<std::string>(empty.view()) == "xyz");
+	std::filesystem::remove(path);
+	std::filesystem::remove(other_path);
+}
+TEST_CASE("mapped_file reports missing files", "[mapped_file]") {
+	CHECK_THROWS_AS(fsv::mapped_file("/nonexistent/fsv_mapped_file"), std::system_error);
+}
+TEST_CASE("mapped_file rejects files it cannot map", "[mapped_file]") {
+	auto fifo = (std::filesystem::temp_directory_path() / "fsv_mapped_file_fifo").string();
+	std::filesystem::remove(fifo);
+	REQUIRE(::mkfifo(fifo.c_str(), 0600) == 0);
+	CHECK_THROWS_AS(fsv::mapped_file(fifo), std::system_error);
+	std::filesystem::remove(fifo);
+
+	CHECK_THROWS_AS(fsv::mapped_file("/dev/null"), std::system_error);
+	if (std::filesystem::exists("/proc/self/status")) {
+		CHECK_THROWS_AS(fsv::mapped_file("/proc/self/status"), std::system_error);
+	}
+}
@@ -0,0 +1,226 @@
+#include "./parallel.h"
+
+#include <algorithm>
+#include <exception>
+#include <numeric>
+
+namespace {
+	// chunks smaller than this are not worth handing to another thread
+	constexpr auto min_chunk_size = std::size_t{1} << 20;
+	// batch cost of a view on top of its underlying length: construction, predicate dispatch, the call
+	constexpr auto per_view_cost = std::size_t{64};
+
+	// Boundaries of roughly equal chunks of a buffer of the given length, a few per thread so a slow
+	// chunk (one with an expensive run structure) does not hold up the whole call. Chunk i is
+	// [bounds[i], bounds[i + 1]).
+	auto chunk_bounds(std::size_t length, const fsv::thread_pool& pool) -> std::vector<std::size_t> {
+		auto chunks = std::max(std::size_t{1}, std::min((pool.size() + 1) * 4, length / min_chunk_size));
+		auto bounds = std::vector<std::size_t>(chunks + 1);
+		for (std::size_t i = 0; i <= chunks; ++i) {
+			bounds[i] = length * i / chunks;
+		}
+		return bounds;
+	}
+	auto chunk_views(const fsv::filtered_string_view& fsv, const fsv::thread_pool& pool)
+	    -> std::vector<fsv::filtered_string_view> {
+		auto bounds = chunk_bounds(fsv.underlying_size(), pool);
+		auto views = std::vector<fsv::filtered_string_view>();
+		if (bounds.size() == 2) {
+			views.push_back(fsv);
+			return views;
+		}
+		views.reserve(bounds.size() - 1);
+		for (std::size_t i = 0; i + 1 < bounds.size(); ++i) {
+			views.emplace_back(fsv.data() + bounds[i], bounds[i + 1] - bounds[i], fsv.predicate());
+		}
+		return views;
+	}
+	auto chunk_sizes(const std::vector<fsv::filtered_string_view>& chunks, fsv::thread_pool& pool)
+	    -> std::vector<std::size_t> {
+		auto sizes = std::vector<std::size_t>(chunks.size());
+		pool.parallel_for(chunks.size(), [&](std::size_t i) { sizes[i] = chunks[i].size(); });
+		return sizes;
+	}
+
+	// first occurrence of the delimiter [delim, delim + delim_size) in [first, last), or last
+	auto find_delimiter(const char* first, const char* last, const char* delim, std::size_t delim_size) -> const char* {
+		if (delim_size == 1) {
+			auto found = std::memchr(first, *delim, static_cast<std::size_t>(last - first));
+			return found ? static_cast<const char*>(found) : last;
+		}
+		return std::search(first, last, delim, delim + delim_size);
+	}
+	// Offsets of the delimiters that start in [first, last) when searching greedily from first, the same
+	// way the sequential split does. A match may run up to delim_size - 1 bytes past last.
+	auto find_delimiters(const char* base, std::size_t length, std::size_t first, std::size_t last, std::string_view delim)
+	    -> std::vector<std::size_t> {
+		auto matches = std::vector<std::size_t>();
+		auto search_end = base + std::min(length, last + delim.size() - 1);
+		for (auto current = base + first;;) {
+			auto found = find_delimiter(current, search_end, delim.data(), delim.size());
+			if (found == search_end or found >= base + last) {
+				return matches;
+			}
+			matches.push_back(static_cast<std::size_t>(found - base));
+			current = found + delim.size();
+		}
+	}
+} // namespace
+
+auto fsv::detail::batch_groups(const std::vector<filtered_string_view>& views, const thread_pool& pool)
+    -> std::vector<std::pair<std::size_t, std::size_t>> {
+	auto cost = [](const filtered_string_view& view) { return view.underlying_size() + per_view_cost; };
+	auto total = std::size_t{0};
+	for (const auto& view : views) {
+		total += cost(view);
+	}
+	auto share = std::max(total / ((pool.size() + 1) * 8), min_chunk_size / 16);
+
+	auto groups = std::vector<std::pair<std::size_t, std::size_t>>();
+	auto group_costs = std::vector<std::size_t>();
+	for (std::size_t first = 0; first < views.size();) {
+		auto last = first;
+		auto group_cost = std::size_t{0};
+		while (last < views.size() and (group_cost == 0 or group_cost + cost(views[last]) <= share)) {
+			group_cost += cost(views[last++]);
+		}
+		groups.emplace_back(first, last);
+		group_costs.push_back(group_cost);
+		first = last;
+	}
+
+	auto order = std::vector<std::size_t>(groups.size());
+	std::iota(order.begin(), order.end(), std::size_t{0});
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+		return group_costs[a] > group_costs[b];
+	});
+	auto sorted = std::vector<std::pair<std::size_t, std::size_t>>();
+	sorted.reserve(groups.size());
+	for (auto g : order) {
+		sorted.push_back(groups[g]);
+	}
+	return sorted;
+}
+auto fsv::parallel_size(const filtered_string_view& fsv, thread_pool& pool) -> std::size_t {
+	auto chunks = chunk_views(fsv, pool);
+	if (chunks.size() == 1) {
+		return fsv.size();
+	}
+	auto sizes = chunk_sizes(chunks, pool);
+	return std::accumulate(sizes.begin(), sizes.end(), std::size_t{0});
+}
+auto fsv::parallel_string(const filtered_string_view& fsv, thread_pool& pool) -> std::string {
+	auto chunks = chunk_views(fsv, pool);
+	if (chunks.size() == 1) {
+		return static_cast<std::string>(fsv);
+	}
+	auto sizes = chunk_sizes(chunks, pool);
+	auto offsets = std::vector<std::size_t>(sizes.size());
+	std::exclusive_scan(sizes.begin(), sizes.end(), offsets.begin(), std::size_t{0});
+	auto total = offsets.back() + sizes.back();
+	auto fill = [&](char* data) {
+		pool.parallel_for(chunks.size(), [&](std::size_t i) {
+			auto out = data + offsets[i];
+			chunks[i].for_each_run([&out](const char* run, std::size_t count) {
+				std::memcpy(out, run, count);
+				out += count;
+			});
+		});
+	};
+#if defined(__cpp_lib_string_resize_and_overwrite)
+	// The buffer is left uninitialised, so each chunk's task is the first to touch its own output range.
+	// The operation must not throw, so a predicate's exception is carried out and rethrown here.
+	auto result = std::string();
+	auto error = std::exception_ptr();
+	result.resize_and_overwrite(total, [&](char* data, std::size_t n) {
+		try {
+			fill(data);
+			return n;
+		} catch (...) {
+			error = std::current_exception();
+			return std::size_t{0};
+		}
+	});
+	if (error) {
+		std::rethrow_exception(error);
+	}
+#else
+	// a serial zero-fill of the whole result, as std::string has no uninitialised resize before C++23
+	auto result = std::string(total, '\0');
+	fill(result.data());
+#endif
+	return result;
+}
+auto fsv::parallel_substr(const filtered_string_view& fsv, std::size_t pos, std::size_t count, thread_pool& pool)
+    -> filtered_string_view {
+	auto chunks = chunk_views(fsv, pool);
+	if (chunks.size() == 1) {
+		return substr(fsv, pos, count);
+	}
+	auto sizes = chunk_sizes(chunks, pool);
+	// the chunk holding filtered position n, with n rebased to that chunk
+	auto locate = [&sizes](std::size_t n) {
+		auto chunk = std::size_t{0};
+		while (n >= sizes[chunk]) {
+			n -= sizes[chunk++];
+		}
+		return std::pair(chunk, n);
+	};
+	auto total = std::accumulate(sizes.begin(), sizes.end(), std::size_t{0});
+	if (pos >= total) {
+		return filtered_string_view("", 0, fsv.predicate());
+	}
+	auto [first_chunk, first_pos] = locate(pos);
+	auto last = count == 0 or count >= total - pos ? total - 1 : pos + count - 1;
+	auto [last_chunk, last_pos] = locate(last);
+	auto start = &chunks[first_chunk][first_pos];
+	auto stop = &chunks[last_chunk][last_pos] + 1;
+	return filtered_string_view(start, static_cast<std::size_t>(stop - start), fsv.predicate());
+}
+auto fsv::parallel_split(const filtered_string_view& fsv, const filtered_string_view& tok, thread_pool& pool)
+    -> std::vector<filtered_string_view> {
+	auto base = fsv.data();
+	auto length = fsv.underlying_size();
+	auto delim = std::string_view(tok.data(), tok.underlying_size());
+	auto bounds = chunk_bounds(length, pool);
+	if (bounds.size() == 2 or tok.size() == 0) {
+		return split(fsv, tok);
+	}
+
+	auto chunks = bounds.size() - 1;
+	auto chunk_matches = std::vector<std::vector<std::size_t>>(chunks);
+	pool.parallel_for(chunks, [&](std::size_t i) {
+		chunk_matches[i] = find_delimiters(base, length, bounds[i], bounds[i + 1], delim);
+	});
+	// Stitch the chunks together in order. Each chunk was searched from its own start, which agrees with
+	// the sequential search unless a delimiter straddling the previous boundary has consumed the start of
+	// this chunk; then the chunk is searched again from the end of that delimiter.
+	auto matches = std::vector<std::size_t>();
+	auto next_allowed = std::size_t{0};
+	for (std::size_t i = 0; i < chunks; ++i) {
+		if (next_allowed > bounds[i]) {
+			chunk_matches[i] = next_allowed < bounds[i + 1]
+			                       ? find_delimiters(base, length, next_allowed, bounds[i + 1], delim)
+			                       : std::vector<std::size_t>();
+		}
+		matches.insert(matches.end(), chunk_matches[i].begin(), chunk_matches[i].end());
+		if (not chunk_matches[i].empty()) {
+			next_allowed = chunk_matches[i].back() + delim.size();
+		}
+	}
+
+	// piece j runs from the end of delimiter j - 1 to the start of delimiter j
+	auto pieces = std::vector<filtered_string_view>(matches.size() + 1);
+	auto blocks = chunks;
+	pool.parallel_for(blocks, [&](std::size_t block) {
+		auto first = pieces.size() * block / blocks;
+		auto last = pieces.size() * (block + 1) / blocks;
+		for (auto j = first; j < last; ++j) {
+			auto start = j == 0 ? 0 : matches[j - 1] + delim.size();
+			auto stop = j == matches.size() ? length : matches[j];
+			pieces[j] = start == stop ? filtered_string_view("", 0, fsv.predicate())
+			                          : filtered_string_view(base + start, stop - start, fsv.predicate());
+		}
+	});
+	return pieces;
+}
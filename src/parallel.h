@@ -0,0 +1,149 @@
+#ifndef COMP6771_ASS2_PARALLEL_H
+#define COMP6771_ASS2_PARALLEL_H
+
+#include "./filtered_string_view.h"
+#include "./thread_pool.h"
+
+#include <cstddef>
+#include <execution>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace fsv {
+	// Parallel versions of size() and operator std::string() for very large views. The underlying buffer is
+	// split into chunks that are counted concurrently; materialization then writes each chunk's accepted
+	// characters straight to its final offset. Views smaller than a few chunks are handled on the calling
+	// thread. The predicate is called from several threads at once, so it must be safe to share.
+	// parallel_string allocates its result uninitialised with C++23's resize_and_overwrite; in C++20
+	// builds the result is zero-filled on the calling thread before the parallel copy, which is a serial
+	// pass over the whole output.
+	auto parallel_size(const filtered_string_view& fsv, thread_pool& pool = default_thread_pool()) -> std::size_t;
+	auto parallel_string(const filtered_string_view& fsv, thread_pool& pool = default_thread_pool()) -> std::string;
+	// Parallel substr(): chunk counts locate the chunks holding the first and last characters, so only
+	// those two chunks are walked.
+	auto parallel_substr(const filtered_string_view& fsv,
+	                     std::size_t pos,
+	                     std::size_t count = 0,
+	                     thread_pool& pool = default_thread_pool()) -> filtered_string_view;
+	// Parallel split(): chunks of the underlying buffer are searched for the delimiter concurrently, the
+	// per-chunk matches are stitched together in order (re-searching a chunk whose start was consumed by a
+	// delimiter straddling the boundary), and the pieces are built concurrently. Gives exactly the pieces
+	// split() does.
+	auto parallel_split(const filtered_string_view& fsv,
+	                    const filtered_string_view& tok,
+	                    thread_pool& pool = default_thread_pool()) -> std::vector<filtered_string_view>;
+
+	namespace detail {
+		// Groups consecutive views into tasks of roughly equal cost (underlying length plus a fixed
+		// per-view overhead), a few tasks per thread. A view costing more than a task's share gets a task
+		// of its own. Returns [first, last) index ranges, most expensive first, so the big ones start early.
+		auto batch_groups(const std::vector<filtered_string_view>& views, const thread_pool& pool)
+		    -> std::vector<std::pair<std::size_t, std::size_t>>;
+
+		template<typename ExecutionPolicy>
+		constexpr bool is_parallel_policy =
+		    std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_policy>
+		    or std::is_same_v<std::remove_cvref_t<ExecutionPolicy>, std::execution::parallel_unsequenced_policy>;
+	} // namespace detail
+
+	// Execution-policy overloads, so call sites opt into parallelism by adding std::execution::par (or
+	// par_unseq) in front of the arguments. seq and unseq run the sequential algorithm; vectorization of
+	// table predicates happens either way. Parallel policies run on default_thread_pool().
+	template<typename ExecutionPolicy>
+	    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	auto size(ExecutionPolicy&&, const filtered_string_view& fsv) -> std::size_t {
+		if constexpr (detail::is_parallel_policy<ExecutionPolicy>) {
+			return parallel_size(fsv);
+		}
+		else {
+			return fsv.size();
+		}
+	}
+	template<typename ExecutionPolicy>
+	    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	auto to_string(ExecutionPolicy&&, const filtered_string_view& fsv) -> std::string {
+		if constexpr (detail::is_parallel_policy<ExecutionPolicy>) {
+			return parallel_string(fsv);
+		}
+		else {
+			return static_cast<std::string>(fsv);
+		}
+	}
+	template<typename ExecutionPolicy>
+	    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	auto substr(ExecutionPolicy&&, const filtered_string_view& fsv, std::size_t pos, std::size_t count = 0)
+	    -> filtered_string_view {
+		if constexpr (detail::is_parallel_policy<ExecutionPolicy>) {
+			return parallel_substr(fsv, pos, count);
+		}
+		else {
+			return substr(fsv, pos, count);
+		}
+	}
+	template<typename ExecutionPolicy>
+	    requires std::is_execution_policy_v<std::remove_cvref_t<ExecutionPolicy>>
+	auto split(ExecutionPolicy&&, const filtered_string_view& fsv, const filtered_string_view& tok)
+	    -> std::vector<filtered_string_view> {
+		if constexpr (detail::is_parallel_policy<ExecutionPolicy>) {
+			return parallel_split(fsv, tok);
+		}
+		else {
+			return split(fsv, tok);
+		}
+	}
+
+	// The same operations on an explicit pool.
+	inline auto size(thread_pool& pool, const filtered_string_view& fsv) -> std::size_t {
+		return parallel_size(fsv, pool);
+	}
+	inline auto to_string(thread_pool& pool, const filtered_string_view& fsv) -> std::string {
+		return parallel_string(fsv, pool);
+	}
+	inline auto substr(thread_pool& pool, const filtered_string_view& fsv, std::size_t pos, std::size_t count = 0)
+	    -> filtered_string_view {
+		return parallel_substr(fsv, pos, count, pool);
+	}
+	inline auto split(thread_pool& pool, const filtered_string_view& fsv, const filtered_string_view& tok)
+	    -> std::vector<filtered_string_view> {
+		return parallel_split(fsv, tok, pool);
+	}
+
+	// Calls f(views[i]) for every view on the pool, with cost-aware grouping (see detail::batch_groups).
+	// f is called from several threads at once.
+	template<typename F>
+	auto batch_for_each(const std::vector<filtered_string_view>& views, F f, thread_pool& pool = default_thread_pool())
+	    -> void {
+		auto groups = detail::batch_groups(views, pool);
+		pool.parallel_for(groups.size(), [&](std::size_t g) {
+			for (auto i = groups[g].first; i < groups[g].second; ++i) {
+				f(views[i]);
+			}
+		});
+	}
+	// Returns f(views[i]) for every view, computed as batch_for_each does. The result type must be
+	// default constructible.
+	template<typename F>
+	auto batch_transform(const std::vector<filtered_string_view>& views, F f, thread_pool& pool = default_thread_pool())
+	    -> std::vector<std::invoke_result_t<F&, const filtered_string_view&>> {
+		using result_type = std::invoke_result_t<F&, const filtered_string_view&>;
+		// std::vector<bool> packs bits, so writes to neighbouring elements from different threads would race
+		using slot_type = std::conditional_t<std::is_same_v<result_type, bool>, unsigned char, result_type>;
+		auto slots = std::vector<slot_type>(views.size());
+		auto groups = detail::batch_groups(views, pool);
+		pool.parallel_for(groups.size(), [&](std::size_t g) {
+			for (auto i = groups[g].first; i < groups[g].second; ++i) {
+				slots[i] = static_cast<slot_type>(f(views[i]));
+			}
+		});
+		if constexpr (std::is_same_v<result_type, bool>) {
+			return std::vector<bool>(slots.begin(), slots.end());
+		}
+		else {
+			return slots;
+		}
+	}
+} // namespace fsv
+
+#endif // COMP6771_ASS2_PARALLEL_H
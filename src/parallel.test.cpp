@@ -0,0 +1,159 @@
+#include "./parallel.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+	// a little over two chunks' worth, built once
+	auto large_input() -> const std::string& {
+		static const auto input = [] {
+			auto text = std::string();
+			for (std::size_t i = 0; text.size() < (std::size_t{5} << 19); ++i) {
+				text += "line " + std::to_string(i) + ": ##payload##\n";
+			}
+			return text;
+		}();
+		return input;
+	}
+} // namespace
+
+TEST_CASE("parallel_size and parallel_string match the sequential results", "[parallel]") {
+	const auto& input = large_input();
+	auto pool = fsv::thread_pool(3);
+	auto opaque = fsv::filtered_string_view{input, [](const char& c) { return c != '#'; }};
+	auto table = fsv::filtered_string_view{input, ~fsv::byte_set{"#"}};
+	for (const auto* sv : {&opaque, &table}) {
+		CHECK(fsv::parallel_size(*sv, pool) == sv->size());
+		CHECK(fsv::parallel_string(*sv, pool) == static_cast<std::string>(*sv));
+	}
+}
+TEST_CASE("parallel_string rethrows an exception thrown while copying", "[parallel]") {
+	const auto& input = large_input();
+	auto pool = fsv::thread_pool(3);
+	// counting calls the predicate once per character, so this throws part way through the copy
+	auto calls = std::atomic<std::size_t>(0);
+	auto sv = fsv::filtered_string_view{input, [&calls, limit = input.size() + 1000](const char& c) {
+		                                    if (calls.fetch_add(1) == limit) {
+			                                    throw std::runtime_error("predicate failed");
+		                                    }
+		                                    return c != '#';
+	                                    }};
+	CHECK_THROWS_AS(fsv::parallel_string(sv, pool), std::runtime_error);
+	CHECK(calls.load() > input.size());
+}
+TEST_CASE("parallel_size and parallel_string handle small views on the calling thread", "[parallel]") {
+	auto sv = fsv::filtered_string_view{"a#b#c", [](const char& c) { return c != '#'; }};
+	CHECK(fsv::parallel_size(sv) == 3);
+	CHECK(fsv::parallel_string(sv) == "abc");
+	CHECK(fsv::parallel_string(fsv::filtered_string_view{}).empty());
+}
+TEST_CASE("parallel_substr matches substr at chunk boundaries", "[parallel]") {
+	const auto& input = large_input();
+	auto pool = fsv::thread_pool(3);
+	auto sv = fsv::filtered_string_view{input, ~fsv::byte_set{"#"}};
+	auto total = sv.size();
+	for (auto [pos, count] : std::vector<std::pair<std::size_t, std::size_t>>{{0, 0},
+	                                                                         {0, 10},
+	                                                                         {total / 3 - 5, 10},
+	                                                                         {total / 2, total},
+	                                                                         {total - 1, 0},
+	                                                                         {total, 0}}) {
+		auto expected = fsv::substr(sv, pos, count);
+		auto actual = fsv::parallel_substr(sv, pos, count, pool);
+		CHECK(actual == expected);
+		if (pos < total) {
+			CHECK(actual.data() == expected.data());
+			CHECK(actual.underlying_size() == expected.underlying_size());
+		}
+	}
+}
+TEST_CASE("execution policy and executor overloads agree with the sequential calls", "[parallel]") {
+	const auto& input = large_input();
+	auto pool = fsv::thread_pool(2);
+	auto sv = fsv::filtered_string_view{input, [](const char& c) { return c != '#'; }};
+	auto expected = static_cast<std::string>(sv);
+
+	CHECK(fsv::size(std::execution::seq, sv) == expected.size());
+	CHECK(fsv::size(std::execution::par, sv) == expected.size());
+	CHECK(fsv::size(pool, sv) == expected.size());
+	CHECK(fsv::to_string(std::execution::par_unseq, sv) == expected);
+	CHECK(fsv::to_string(pool, sv) == expected);
+	CHECK(fsv::substr(std::execution::par, sv, 100, 20) == fsv::substr(sv, 100, 20));
+	CHECK(fsv::substr(pool, sv, 100) == fsv::substr(sv, std::size_t{100}));
+
+	auto small = fsv::filtered_string_view{"a,b,c"};
+	CHECK(fsv::split(std::execution::par, small, ",") == fsv::split(small, ","));
+	CHECK(fsv::split(pool, small, ",").size() == 3);
+}
+namespace {
+	// same underlying ranges (empty pieces may point at different empty strings)
+	auto same_pieces(const std::vector<fsv::filtered_string_view>& actual,
+	                 const std::vector<fsv::filtered_string_view>& expected) -> bool {
+		return std::equal(actual.begin(),
+		                  actual.end(),
+		                  expected.begin(),
+		                  expected.end(),
+		                  [](const fsv::filtered_string_view& lhs, const fsv::filtered_string_view& rhs) {
+			                  return lhs.underlying_size() == rhs.underlying_size()
+			                         and (lhs.underlying_size() == 0 or lhs.data() == rhs.data());
+		                  });
+	}
+} // namespace
+TEST_CASE("parallel_split gives the same pieces as split", "[parallel][split]") {
+	const auto& input = large_input();
+	auto pool = fsv::thread_pool(3);
+	auto sv = fsv::filtered_string_view{input, ~fsv::byte_set{"#"}};
+	CHECK(same_pieces(fsv::parallel_split(sv, "\n", pool), fsv::split(sv, "\n")));
+	CHECK(same_pieces(fsv::parallel_split(sv, "##", pool), fsv::split(sv, "##")));
+	CHECK(same_pieces(fsv::split(std::execution::par, sv, "payload"), fsv::split(sv, "payload")));
+}
+TEST_CASE("parallel_split stitches self-overlapping delimiters across chunk boundaries", "[parallel][split]") {
+	// every chunk boundary falls inside a long run of 'a's, so greedy matches of "aaa" straddle it
+	auto input = std::string(std::size_t{5} << 19, 'a');
+	input[1001] = 'b';
+	input[input.size() * 3 / 4] = 'b';
+	auto pool = fsv::thread_pool(3);
+	auto sv = fsv::filtered_string_view{input};
+	CHECK(same_pieces(fsv::parallel_split(sv, "aaa", pool), fsv::split(sv, "aaa")));
+	CHECK(same_pieces(fsv::parallel_split(sv, "aab", pool), fsv::split(sv, "aab")));
+	CHECK(same_pieces(fsv::parallel_split(sv, "", pool), fsv::split(sv, "")));
+}
+TEST_CASE("batch_groups covers every view once and isolates huge views", "[parallel][batch]") {
+	auto pool = fsv::thread_pool(2);
+	const auto& huge = large_input();
+	auto views = std::vector<fsv::filtered_string_view>(5000, fsv::filtered_string_view{"tiny"});
+	views[2500] = fsv::filtered_string_view{huge};
+	auto groups = fsv::detail::batch_groups(views, pool);
+	REQUIRE(not groups.empty());
+	CHECK(groups.front() == std::pair<std::size_t, std::size_t>{2500, 2501});
+
+	std::sort(groups.begin(), groups.end());
+	auto expected_first = std::size_t{0};
+	for (const auto& [first, last] : groups) {
+		CHECK(first == expected_first);
+		CHECK(first < last);
+		expected_first = last;
+	}
+	CHECK(expected_first == views.size());
+	CHECK(fsv::detail::batch_groups({}, pool).empty());
+}
+TEST_CASE("batch_transform and batch_for_each apply the operation to every view", "[parallel][batch]") {
+	auto pool = fsv::thread_pool(3);
+	auto lines = fsv::split(fsv::filtered_string_view{large_input(), ~fsv::byte_set{"#"}}, "\n");
+	auto sizes = fsv::batch_transform(lines, [](const fsv::filtered_string_view& sv) { return sv.size(); }, pool);
+	auto matches = fsv::batch_transform(
+	    lines,
+	    [](const fsv::filtered_string_view& sv) { return sv == fsv::filtered_string_view{"line 7: payload"}; },
+	    pool);
+	REQUIRE(sizes.size() == lines.size());
+	REQUIRE(matches.size() == lines.size());
+	CHECK(sizes[7] == 15);
+	CHECK(std::count(matches.begin(), matches.end(), true) == 1);
+	CHECK(matches[7]);
+
+	auto visited = std::atomic<std::size_t>(0);
+	fsv::batch_for_each(lines, [&visited](const fsv::filtered_string_view&) { ++visited; }, pool);
+	CHECK(visited == lines.size());
+}
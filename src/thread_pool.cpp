@@ -0,0 +1,144 @@
+#include "./thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <utility>
+
+namespace {
+	// Shared between parallel_for and its helper tasks. Helpers that only start after every index has
+	// been claimed still hold a reference, so this must outlive the parallel_for call.
+	struct loop_state {
+		std::size_t n;
+		const std::function<void(std::size_t)>* fn;
+		std::atomic<std::size_t> next = 0;
+		std::size_t done = 0;
+		std::exception_ptr error;
+		std::mutex mutex;
+		std::condition_variable finished;
+
+		// claim and run indices until none are left
+		auto run() -> void {
+			for (auto i = next.fetch_add(1); i < n; i = next.fetch_add(1)) {
+				auto error_here = std::exception_ptr();
+				try {
+					(*fn)(i);
+				} catch (...) {
+					error_here = std::current_exception();
+				}
+				auto lock = std::lock_guard(mutex);
+				if (error_here and not error) {
+					error = error_here;
+				}
+				if (++done == n) {
+					finished.notify_all();
+				}
+			}
+		}
+	};
+
+	// the pool and queue index of the worker running on this thread, if any
+	thread_local const fsv::thread_pool* current_pool = nullptr;
+	thread_local std::size_t current_index = 0;
+} // namespace
+
+fsv::thread_pool::thread_pool(std::size_t threads) {
+	if (threads == 0) {
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	queues_.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i) {
+		queues_.push_back(std::make_unique<task_queue>());
+	}
+	workers_.reserve(threads);
+	for (std::size_t i = 0; i < threads; ++i) {
+		workers_.emplace_back([this, i] { work(i); });
+	}
+}
+fsv::thread_pool::~thread_pool() {
+	{
+		auto lock = std::lock_guard(sleep_mutex_);
+		stopping_ = true;
+	}
+	ready_.notify_all();
+	for (auto& worker : workers_) {
+		worker.join();
+	}
+}
+auto fsv::thread_pool::size() const noexcept -> std::size_t {
+	return workers_.size();
+}
+auto fsv::thread_pool::submit(std::function<void()> task) -> void {
+	auto index = current_pool == this ? current_index : next_queue_.fetch_add(1) % queues_.size();
+	// counted before it is queued, so the count can't drop below zero when the task is taken at once
+	{
+		auto lock = std::lock_guard(sleep_mutex_);
+		++pending_;
+	}
+	{
+		auto lock = std::lock_guard(queues_[index]->mutex);
+		queues_[index]->tasks.push_back(std::move(task));
+	}
+	ready_.notify_one();
+}
+auto fsv::thread_pool::parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn) -> void {
+	if (n == 0) {
+		return;
+	}
+	auto state = std::make_shared<loop_state>();
+	state->n = n;
+	state->fn = &fn;
+	// the calling thread takes part too, so one helper fewer than there are indices is enough
+	auto helpers = std::min(size(), n - 1);
+	for (std::size_t i = 0; i < helpers; ++i) {
+		submit([state] { state->run(); });
+	}
+	state->run();
+	auto lock = std::unique_lock(state->mutex);
+	state->finished.wait(lock, [&state] { return state->done == state->n; });
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+}
+auto fsv::thread_pool::work(std::size_t index) -> void {
+	current_pool = this;
+	current_index = index;
+	while (true) {
+		if (auto task = take(index)) {
+			(*task)();
+			continue;
+		}
+		auto lock = std::unique_lock(sleep_mutex_);
+		if (stopping_ and pending_ == 0) {
+			return;
+		}
+		ready_.wait(lock, [this] { return stopping_ or pending_ > 0; });
+	}
+}
+auto fsv::thread_pool::take(std::size_t index) -> std::optional<std::function<void()>> {
+	for (std::size_t i = 0; i < queues_.size(); ++i) {
+		auto& queue = *queues_[(index + i) % queues_.size()];
+		auto lock = std::lock_guard(queue.mutex);
+		if (queue.tasks.empty()) {
+			continue;
+		}
+		auto task = std::optional<std::function<void()>>();
+		if (i == 0) {
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+		}
+		else {
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+		}
+		--pending_;
+		return task;
+	}
+	return std::nullopt;
+}
+
+auto fsv::default_thread_pool() -> thread_pool& {
+	static auto pool = thread_pool();
+	return pool;
+}
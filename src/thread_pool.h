@@ -0,0 +1,63 @@
+#ifndef COMP6771_ASS2_THREAD_POOL_H
+#define COMP6771_ASS2_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace fsv {
+	// Fixed-size work-stealing pool used by the parallel algorithms. Every worker owns a task deque: tasks
+	// submitted from a worker go to the back of its own deque and are taken from there (newest first),
+	// tasks submitted from outside are dealt out round-robin, and an idle worker steals the oldest task
+	// from another worker's deque.
+	class thread_pool {
+	 public:
+		// threads == 0 uses std::thread::hardware_concurrency()
+		explicit thread_pool(std::size_t threads = 0);
+		thread_pool(const thread_pool& other) = delete;
+		thread_pool(thread_pool&& other) = delete;
+		// finishes the queued tasks, then joins the workers
+		~thread_pool();
+
+		auto operator=(const thread_pool& other) -> thread_pool& = delete;
+		auto operator=(thread_pool&& other) -> thread_pool& = delete;
+
+		auto size() const noexcept -> std::size_t;
+		// queue a task; tasks must not throw
+		auto submit(std::function<void()> task) -> void;
+		// Runs fn(0), ..., fn(n - 1) on the workers and the calling thread and returns once all of them
+		// have finished. The first exception thrown by fn is rethrown here. Safe to call from a worker.
+		auto parallel_for(std::size_t n, const std::function<void(std::size_t)>& fn) -> void;
+
+	 private:
+		struct task_queue {
+			std::mutex mutex;
+			std::deque<std::function<void()>> tasks;
+		};
+
+		auto work(std::size_t index) -> void;
+		// own newest task, else the oldest task of another worker
+		auto take(std::size_t index) -> std::optional<std::function<void()>>;
+
+		std::vector<std::unique_ptr<task_queue>> queues_;
+		std::atomic<std::size_t> next_queue_ = 0;
+		// workers sleep on ready_ while nothing is pending
+		std::mutex sleep_mutex_;
+		std::condition_variable ready_;
+		std::atomic<std::size_t> pending_ = 0;
+		bool stopping_ = false;
+		std::vector<std::thread> workers_;
+	}; // thread_pool
+
+	// process-wide pool sized to the hardware, created on first use
+	auto default_thread_pool() -> thread_pool&;
+} // namespace fsv
+
+#endif // COMP6771_ASS2_THREAD_POOL_H
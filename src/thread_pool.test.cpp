@@ -0,0 +1,28 @@
+#include "./thread_pool.h"
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <stdexcept>
+
+TEST_CASE("parallel_for runs every index exactly once", "[thread_pool]") {
+	auto pool = fsv::thread_pool(4);
+	CHECK(pool.size() == 4);
+	auto hits = std::vector<std::atomic<int>>(1000);
+	pool.parallel_for(hits.size(), [&hits](std::size_t i) { ++hits[i]; });
+	CHECK(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }));
+}
+TEST_CASE("parallel_for rethrows and can be nested", "[thread_pool]") {
+	auto pool = fsv::thread_pool(2);
+	CHECK_THROWS_AS(pool.parallel_for(10,
+	                                  [](std::size_t i) {
+		                                  if (i == 7) {
+			                                  throw std::runtime_error("boom");
+		                                  }
+	                                  }),
+	                std::runtime_error);
+
+	auto total = std::atomic<std::size_t>(0);
+	pool.parallel_for(4, [&](std::size_t) { pool.parallel_for(4, [&](std::size_t j) { total += j; }); });
+	CHECK(total == 4 * 6);
+}
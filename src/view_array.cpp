@@ -0,0 +1,104 @@
+#include "./view_array.h"
+
+#include <algorithm>
+#include <utility>
+
+fsv::view_array::view_array()
+: predicate_(filtered_string_view::default_predicate) {}
+fsv::view_array::view_array(filter predicate)
+: predicate_(std::move(predicate)) {}
+fsv::view_array::view_array(const std::vector<std::string>& strings, filter predicate)
+: predicate_(std::move(predicate)) {
+	reserve(strings.size());
+	for (const auto& str : strings) {
+		push_back(str);
+	}
+}
+auto fsv::view_array::push_back(const char* data, std::size_t length) -> void {
+	data_.push_back(data);
+	lengths_.push_back(length);
+}
+auto fsv::view_array::push_back(const std::string& str) -> void {
+	push_back(str.data(), str.size());
+}
+auto fsv::view_array::reserve(std::size_t n) -> void {
+	data_.reserve(n);
+	lengths_.reserve(n);
+}
+auto fsv::view_array::size() const noexcept -> std::size_t {
+	return data_.size();
+}
+auto fsv::view_array::empty() const noexcept -> bool {
+	return data_.empty();
+}
+auto fsv::view_array::operator[](std::size_t i) const -> filtered_string_view {
+	return filtered_string_view(data_[i], lengths_[i], predicate_);
+}
+auto fsv::view_array::data(std::size_t i) const noexcept -> const char* {
+	return data_[i];
+}
+auto fsv::view_array::underlying_size(std::size_t i) const noexcept -> std::size_t {
+	return lengths_[i];
+}
+auto fsv::view_array::predicate() const noexcept -> const filter& {
+	return predicate_;
+}
+auto fsv::view_array::size(std::size_t i) const -> std::size_t {
+	return count_accepted(predicate_, data_[i], data_[i] + lengths_[i]);
+}
+auto fsv::view_array::assign_to(std::size_t i, std::string& out) const -> void {
+	out.clear();
+	for_each_run(i, [&out](const char* run, std::size_t count) { out.append(run, count); });
+}
+auto fsv::view_array::materialize_into(std::size_t i, std::pmr::memory_resource& arena) const -> std::string_view {
+	auto length = size(i);
+	if (length == 0) {
+		return std::string_view();
+	}
+	auto* chars = static_cast<char*>(arena.allocate(length, alignof(char)));
+	auto* out = chars;
+	for_each_run(i, [&out](const char* run, std::size_t count) { out = std::copy(run, run + count, out); });
+	return std::string_view(chars, length);
+}
+auto fsv::view_array::begin() const noexcept -> iterator {
+	return iterator(this, 0);
+}
+auto fsv::view_array::end() const noexcept -> iterator {
+	return iterator(this, size());
+}
+
+// iterator
+fsv::view_array::iterator::iterator(const view_array* views, std::size_t index) noexcept
+: views_(views)
+, index_(index) {}
+auto fsv::view_array::iterator::operator*() const -> reference {
+	return (*views_)[index_];
+}
+auto fsv::view_array::iterator::operator[](difference_type n) const -> reference {
+	return *(*this + n);
+}
+auto fsv::view_array::iterator::operator++() -> iterator& {
+	++index_;
+	return *this;
+}
+auto fsv::view_array::iterator::operator++(int) -> iterator {
+	auto temp = *this;
+	++*this;
+	return temp;
+}
+auto fsv::view_array::iterator::operator--() -> iterator& {
+	--index_;
+	return *this;
+}
+auto fsv::view_array::iterator::operator--(int) -> iterator {
+	auto temp = *this;
+	--*this;
+	return temp;
+}
+auto fsv::view_array::iterator::operator+=(difference_type n) -> iterator& {
+	index_ = static_cast<std::size_t>(static_cast<difference_type>(index_) + n);
+	return *this;
+}
+auto fsv::view_array::iterator::operator-=(difference_type n) -> iterator& {
+	return *this += -n;
+}
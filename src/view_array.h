@@ -0,0 +1,105 @@
+#ifndef COMP6771_ASS2_VIEW_ARRAY_H
+#define COMP6771_ASS2_VIEW_ARRAY_H
+
+#include "./filtered_string_view.h"
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace fsv {
+	// Many views sharing one predicate, stored as a struct of arrays: a data pointer and a length per view
+	// and a single copy of the predicate. The per-element operations below use the shared predicate in
+	// place. operator[] and the iterators hand out filtered_string_views, each with its own copy of the
+	// predicate, for code that needs a real view.
+	class view_array {
+	 public:
+		class iterator {
+		 public:
+			using iterator_concept = std::random_access_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+			using value_type = filtered_string_view;
+			using reference = filtered_string_view;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() noexcept = default;
+			iterator(const view_array* views, std::size_t index) noexcept;
+
+			auto operator*() const -> reference;
+			auto operator[](difference_type n) const -> reference;
+
+			auto operator++() -> iterator&;
+			auto operator++(int) -> iterator;
+			auto operator--() -> iterator&;
+			auto operator--(int) -> iterator;
+			auto operator+=(difference_type n) -> iterator&;
+			auto operator-=(difference_type n) -> iterator&;
+
+			friend auto operator+(iterator it, difference_type n) -> iterator {
+				return it += n;
+			}
+			friend auto operator+(difference_type n, iterator it) -> iterator {
+				return it += n;
+			}
+			friend auto operator-(iterator it, difference_type n) -> iterator {
+				return it -= n;
+			}
+			friend auto operator-(const iterator& lhs, const iterator& rhs) -> difference_type {
+				return static_cast<difference_type>(lhs.index_) - static_cast<difference_type>(rhs.index_);
+			}
+			friend auto operator==(const iterator& lhs, const iterator& rhs) -> bool {
+				return lhs.index_ == rhs.index_;
+			}
+			friend auto operator<=>(const iterator& lhs, const iterator& rhs) -> std::strong_ordering {
+				return lhs.index_ <=> rhs.index_;
+			}
+
+		 private:
+			const view_array* views_ = nullptr;
+			std::size_t index_ = 0;
+		}; // iterator
+
+		view_array();
+		explicit view_array(filter predicate);
+		// one view per string, all filtered by predicate; the strings must outlive the view_array
+		view_array(const std::vector<std::string>& strings, filter predicate);
+
+		auto push_back(const char* data, std::size_t length) -> void;
+		auto push_back(const std::string& str) -> void;
+		auto reserve(std::size_t n) -> void;
+
+		auto size() const noexcept -> std::size_t;
+		auto empty() const noexcept -> bool;
+		auto operator[](std::size_t i) const -> filtered_string_view;
+		// the parts of view i, without building the view
+		auto data(std::size_t i) const noexcept -> const char*;
+		auto underlying_size(std::size_t i) const noexcept -> std::size_t;
+		auto predicate() const noexcept -> const filter&;
+
+		// Per-element operations on view i, without copying the predicate
+		// the filtered size of view i (size() is the number of views)
+		auto size(std::size_t i) const -> std::size_t;
+		// calls f(run, count) for each accepted run of view i; returning false from f stops the walk
+		template<typename F>
+		auto for_each_run(std::size_t i, F&& f) const -> void {
+			fsv::for_each_run(predicate_, data_[i], data_[i] + lengths_[i], f);
+		}
+		auto assign_to(std::size_t i, std::string& out) const -> void;
+		// the filtered characters of view i, copied into exactly-sized memory from arena
+		auto materialize_into(std::size_t i, std::pmr::memory_resource& arena) const -> std::string_view;
+
+		auto begin() const noexcept -> iterator;
+		auto end() const noexcept -> iterator;
+
+	 private:
+		std::vector<const char*> data_;
+		std::vector<std::size_t> lengths_;
+		filter predicate_;
+	}; // view_array
+} // namespace fsv
+
+#endif // COMP6771_ASS2_VIEW_ARRAY_H
@@ -0,0 +1,88 @@
+#include "./view_array.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <memory_resource>
+
+TEST_CASE("view_array builds views over many strings with one predicate", "[view_array]") {
+	auto rows = std::vector<std::string>{"a-1", "b--2", "", "c3"};
+	auto views = fsv::view_array(rows, fsv::byte_set{"-"});
+	REQUIRE(views.size() == 4);
+	CHECK(views.data(1) == rows[1].data());
+	CHECK(views.underlying_size(1) == 4);
+	CHECK(static_cast<std::string>(views[1]) == "--");
+	CHECK(views[2].empty());
+	CHECK(views.predicate().target<fsv::byte_set>() != nullptr);
+
+	views.push_back("x-y-z", 3);
+	CHECK(static_cast<std::string>(views[4]) == "-");
+}
+TEST_CASE("view_array iterators are random access and yield filtered_string_views", "[view_array]") {
+	static_assert(std::random_access_iterator<fsv::view_array::iterator>);
+	static_assert(std::ranges::random_access_range<fsv::view_array>);
+
+	auto rows = std::vector<std::string>{"x1", "y22", "z333"};
+	auto views = fsv::view_array(rows, [](const char& c) { return std::isdigit(static_cast<unsigned char>(c)); });
+	auto sizes = std::vector<std::size_t>();
+	for (const auto& sv : views) {
+		sizes.push_back(sv.size());
+	}
+	CHECK(sizes == std::vector<std::size_t>{1, 2, 3});
+	CHECK(views.end() - views.begin() == 3);
+	CHECK(static_cast<std::string>(views.begin()[2]) == "333");
+	CHECK(static_cast<std::string>(*std::ranges::prev(views.end())) == "333");
+	CHECK(std::ranges::count_if(views, [](const fsv::filtered_string_view& sv) { return sv.size() > 1; }) == 2);
+	CHECK(fsv::view_array().empty());
+}
+namespace {
+	// accepts digits and counts how often it is copied
+	struct counted_digits {
+		std::size_t* copies;
+
+		explicit counted_digits(std::size_t* counter) noexcept
+		: copies(counter) {}
+		counted_digits(const counted_digits& other) noexcept
+		: copies(other.copies) {
+			++*copies;
+		}
+		auto operator=(const counted_digits& other) noexcept -> counted_digits& = default;
+		auto operator()(const char& c) const -> bool {
+			return std::isdigit(static_cast<unsigned char>(c)) != 0;
+		}
+	};
+} // namespace
+TEST_CASE("view_array per-element operations share the predicate", "[view_array]") {
+	auto copies = std::size_t{0};
+	auto rows = std::vector<std::string>{"x1", "y22", "", "z3-3-3"};
+	auto views = fsv::view_array(rows, counted_digits(&copies));
+	auto arena = std::pmr::monotonic_buffer_resource();
+	auto scratch = std::string();
+
+	copies = 0;
+	auto sizes = std::vector<std::size_t>();
+	auto strings = std::vector<std::string>();
+	auto stored = std::vector<std::string_view>();
+	for (std::size_t i = 0; i < views.size(); ++i) {
+		sizes.push_back(views.size(i));
+		views.assign_to(i, scratch);
+		strings.push_back(scratch);
+		stored.push_back(views.materialize_into(i, arena));
+	}
+	CHECK(copies == 0);
+	CHECK(sizes == std::vector<std::size_t>{1, 2, 0, 3});
+	CHECK(strings == std::vector<std::string>{"1", "22", "", "333"});
+	CHECK(stored == std::vector<std::string_view>{"1", "22", "", "333"});
+
+	auto runs = std::size_t{0};
+	views.for_each_run(3, [&runs](const char*, std::size_t count) {
+		runs += count == 1 ? 1 : 0;
+		return true;
+	});
+	CHECK(runs == 3);
+	CHECK(copies == 0);
+
+	// building a view copies the predicate once
+	CHECK(views[1].size() == 2);
+	CHECK(copies == 1);
+}
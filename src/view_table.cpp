@@ -0,0 +1,181 @@
+#include "./view_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+	// Walks the accepted characters of a row in pieces, so two rows can be compared without copying
+	// either of them.
+	struct run_cursor {
+		const fsv::filter* predicate;
+		const char* last;
+		const char* run;
+		std::size_t left;
+
+		run_cursor(const fsv::filter& pred, const char* first, const char* end) noexcept
+		: predicate(&pred)
+		, last(end)
+		, run(nullptr)
+		, left(0) {
+			load(first);
+		}
+		auto done() const noexcept -> bool {
+			return left == 0;
+		}
+		auto advance(std::size_t n) noexcept -> void {
+			run += n;
+			left -= n;
+			if (left == 0) {
+				load(run);
+			}
+		}
+
+	 private:
+		auto load(const char* from) noexcept -> void {
+			run = fsv::next_accepted(*predicate, from, last);
+			left = static_cast<std::size_t>(fsv::next_rejected(*predicate, run, last) - run);
+		}
+	};
+	// the first 8 filtered bytes of a row, big-endian so that integer order is content order
+	auto prefix_key(const fsv::filter& predicate, const char* first, const char* last) -> std::uint64_t {
+		auto key = std::uint64_t{0};
+		auto filled = 0;
+		fsv::for_each_run(predicate, first, last, [&key, &filled](const char* run, std::size_t count) {
+			for (std::size_t k = 0; k < count and filled < 8; ++k, ++filled) {
+				key |= std::uint64_t{static_cast<unsigned char>(run[k])} << (56 - 8 * filled);
+			}
+			return filled < 8;
+		});
+		return key;
+	}
+} // namespace
+
+fsv::view_table::view_table()
+: view_table(std::string_view()) {}
+fsv::view_table::view_table(std::string_view arena)
+: arena_(arena)
+, predicates_{filtered_string_view::default_predicate} {}
+auto fsv::view_table::add_predicate(filter predicate) -> predicate_id {
+	if (predicates_.size() == max_predicates) {
+		throw std::length_error("view_table::add_predicate: too many predicates");
+	}
+	predicates_.push_back(std::move(predicate));
+	return static_cast<predicate_id>(predicates_.size() - 1);
+}
+auto fsv::view_table::push_back(std::size_t offset, std::size_t length, predicate_id id) -> void {
+	if (offset > arena_.size() or length > arena_.size() - offset) {
+		throw std::out_of_range("view_table::push_back: row [" + std::to_string(offset) + ", "
+		                        + std::to_string(offset + length) + ") is outside the arena");
+	}
+	if (length > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::length_error("view_table::push_back: row longer than 4 GiB");
+	}
+	if (id >= predicates_.size()) {
+		throw std::out_of_range("view_table::push_back: unknown predicate id " + std::to_string(id));
+	}
+	offsets_.push_back(offset);
+	lengths_.push_back(static_cast<std::uint32_t>(length));
+	ids_.push_back(id);
+}
+auto fsv::view_table::reserve(std::size_t n) -> void {
+	offsets_.reserve(n);
+	lengths_.reserve(n);
+	ids_.reserve(n);
+}
+auto fsv::view_table::size() const noexcept -> std::size_t {
+	return offsets_.size();
+}
+auto fsv::view_table::empty() const noexcept -> bool {
+	return offsets_.empty();
+}
+auto fsv::view_table::operator[](std::size_t i) const -> filtered_string_view {
+	return filtered_string_view(row_begin(i), lengths_[i], row_predicate(i));
+}
+auto fsv::view_table::arena() const noexcept -> std::string_view {
+	return arena_;
+}
+auto fsv::view_table::offset(std::size_t i) const noexcept -> std::size_t {
+	return offsets_[i];
+}
+auto fsv::view_table::underlying_size(std::size_t i) const noexcept -> std::size_t {
+	return lengths_[i];
+}
+auto fsv::view_table::predicate(std::size_t i) const noexcept -> predicate_id {
+	return ids_[i];
+}
+auto fsv::view_table::predicates() const noexcept -> const std::vector<filter>& {
+	return predicates_;
+}
+
+// Bulk operations
+auto fsv::view_table::sizes() const -> std::vector<std::size_t> {
+	auto result = std::vector<std::size_t>(size());
+	for (std::size_t i = 0; i < size(); ++i) {
+		result[i] = count_accepted(row_predicate(i), row_begin(i), row_end(i));
+	}
+	return result;
+}
+auto fsv::view_table::find_equal(std::string_view key) const -> std::vector<std::size_t> {
+	auto result = std::vector<std::size_t>();
+	for (std::size_t i = 0; i < size(); ++i) {
+		// a row shorter than the key cannot match, whatever its predicate
+		if (lengths_[i] < key.size()) {
+			continue;
+		}
+		auto matched = std::size_t{0};
+		auto equal = true;
+		for_each_run(row_predicate(i), row_begin(i), row_end(i), [&](const char* run, std::size_t count) {
+			equal = count <= key.size() - matched and std::memcmp(run, key.data() + matched, count) == 0;
+			matched += count;
+			return equal;
+		});
+		if (equal and matched == key.size()) {
+			result.push_back(i);
+		}
+	}
+	return result;
+}
+auto fsv::view_table::sorted_order() const -> std::vector<std::size_t> {
+	// sort on the 8-byte prefixes first, and only compare whole rows whose prefixes tie
+	auto keys = std::vector<std::uint64_t>(size());
+	for (std::size_t i = 0; i < size(); ++i) {
+		keys[i] = prefix_key(row_predicate(i), row_begin(i), row_end(i));
+	}
+	auto order = std::vector<std::size_t>(size());
+	std::iota(order.begin(), order.end(), std::size_t{0});
+	std::stable_sort(order.begin(), order.end(), [this, &keys](std::size_t i, std::size_t j) {
+		if (keys[i] != keys[j]) {
+			return keys[i] < keys[j];
+		}
+		return compare_rows(i, j) < 0;
+	});
+	return order;
+}
+
+auto fsv::view_table::row_begin(std::size_t i) const noexcept -> const char* {
+	return arena_.data() + offsets_[i];
+}
+auto fsv::view_table::row_end(std::size_t i) const noexcept -> const char* {
+	return row_begin(i) + lengths_[i];
+}
+auto fsv::view_table::row_predicate(std::size_t i) const noexcept -> const filter& {
+	return predicates_[ids_[i]];
+}
+auto fsv::view_table::compare_rows(std::size_t i, std::size_t j) const -> int {
+	auto lhs = run_cursor(row_predicate(i), row_begin(i), row_end(i));
+	auto rhs = run_cursor(row_predicate(j), row_begin(j), row_end(j));
+	while (!lhs.done() and !rhs.done()) {
+		auto n = std::min(lhs.left, rhs.left);
+		if (auto result = std::memcmp(lhs.run, rhs.run, n); result != 0) {
+			return result;
+		}
+		lhs.advance(n);
+		rhs.advance(n);
+	}
+	return static_cast<int>(rhs.done()) - static_cast<int>(lhs.done());
+}
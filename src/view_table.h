@@ -0,0 +1,62 @@
+#ifndef COMP6771_ASS2_VIEW_TABLE_H
+#define COMP6771_ASS2_VIEW_TABLE_H
+
+#include "./filtered_string_view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace fsv {
+	// Many views over one arena, stored column-wise: an offset, a 32-bit length and an 8-bit predicate id
+	// per row, and a small dictionary of the distinct predicates. A row costs 13 bytes instead of the 48
+	// of a filtered_string_view, and the bulk operations below walk the columns without building views.
+	class view_table {
+	 public:
+		using predicate_id = std::uint8_t;
+		// id 0 is always the default predicate
+		static constexpr std::size_t max_predicates = 256;
+
+		view_table();
+		// the arena must outlive the view_table
+		explicit view_table(std::string_view arena);
+
+		// adds predicate to the dictionary and returns its id; throws std::length_error when it is full
+		auto add_predicate(filter predicate) -> predicate_id;
+		// adds the row arena[offset, offset + length) filtered by predicate id
+		auto push_back(std::size_t offset, std::size_t length, predicate_id id = 0) -> void;
+		auto reserve(std::size_t n) -> void;
+
+		auto size() const noexcept -> std::size_t;
+		auto empty() const noexcept -> bool;
+		auto operator[](std::size_t i) const -> filtered_string_view;
+		auto arena() const noexcept -> std::string_view;
+		auto offset(std::size_t i) const noexcept -> std::size_t;
+		auto underlying_size(std::size_t i) const noexcept -> std::size_t;
+		auto predicate(std::size_t i) const noexcept -> predicate_id;
+		auto predicates() const noexcept -> const std::vector<filter>&;
+
+		// Bulk operations
+		// the filtered size of every row
+		auto sizes() const -> std::vector<std::size_t>;
+		// the rows whose filtered content equals key, in increasing order
+		auto find_equal(std::string_view key) const -> std::vector<std::size_t>;
+		// row indices ordered by filtered content; rows that compare equal keep their relative order
+		auto sorted_order() const -> std::vector<std::size_t>;
+
+	 private:
+		auto row_begin(std::size_t i) const noexcept -> const char*;
+		auto row_end(std::size_t i) const noexcept -> const char*;
+		auto row_predicate(std::size_t i) const noexcept -> const filter&;
+		auto compare_rows(std::size_t i, std::size_t j) const -> int;
+
+		std::string_view arena_;
+		std::vector<std::size_t> offsets_;
+		std::vector<std::uint32_t> lengths_;
+		std::vector<predicate_id> ids_;
+		std::vector<filter> predicates_;
+	}; // view_table
+} // namespace fsv
+
+#endif // COMP6771_ASS2_VIEW_TABLE_H
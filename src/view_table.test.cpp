@@ -0,0 +1,88 @@
+#include "./view_table.h"
+
+#include <catch2/catch.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+TEST_CASE("view_table stores rows over one arena with a predicate dictionary", "[view_table]") {
+	const auto arena = std::string("a-1b--2c3x-y-z");
+	auto table = fsv::view_table(arena);
+	auto dashes = table.add_predicate(fsv::byte_set{"-"});
+	auto digits = table.add_predicate([](const char& c) { return std::isdigit(static_cast<unsigned char>(c)); });
+	CHECK(dashes == 1);
+	CHECK(digits == 2);
+
+	table.push_back(0, 3, dashes);
+	table.push_back(3, 4, digits);
+	table.push_back(7, 2);
+	table.push_back(9, 0, dashes);
+	REQUIRE(table.size() == 4);
+	CHECK(static_cast<std::string>(table[0]) == "-");
+	CHECK(static_cast<std::string>(table[1]) == "2");
+	CHECK(static_cast<std::string>(table[2]) == "c3");
+	CHECK(table[3].empty());
+	CHECK(table.offset(1) == 3);
+	CHECK(table.underlying_size(1) == 4);
+	CHECK(table.predicate(1) == digits);
+	CHECK(table.predicates().size() == 3);
+	CHECK(table.arena().data() == arena.data());
+
+	CHECK_THROWS_AS(table.push_back(10, 5), std::out_of_range);
+	CHECK_THROWS_AS(table.push_back(0, 1, 7), std::out_of_range);
+	for (auto i = table.predicates().size(); i < fsv::view_table::max_predicates; ++i) {
+		table.add_predicate(fsv::byte_set{"x"});
+	}
+	CHECK_THROWS_AS(table.add_predicate(fsv::byte_set{"y"}), std::length_error);
+	CHECK(table.size() == 4);
+}
+TEST_CASE("view_table bulk operations agree with the views they describe", "[view_table]") {
+	auto arena = std::string();
+	auto rows = std::vector<std::pair<std::size_t, std::size_t>>();
+	for (auto i = 0; i < 200; ++i) {
+		auto row = std::string(static_cast<std::size_t>(i % 37), 'k');
+		for (std::size_t k = 0; k < row.size(); ++k) {
+			row[k] = static_cast<char>('a' + (i * 7 + static_cast<int>(k) * 3) % 5);
+			if (k % 4 == 1) {
+				row[k] = '.';
+			}
+		}
+		rows.emplace_back(arena.size(), row.size());
+		arena += row;
+	}
+	auto table = fsv::view_table(arena);
+	auto no_dots = table.add_predicate(~fsv::byte_set{"."});
+	auto opaque = table.add_predicate([](const char& c) { return c != '.' and c != 'e'; });
+	for (std::size_t i = 0; i < rows.size(); ++i) {
+		table.push_back(rows[i].first, rows[i].second, static_cast<fsv::view_table::predicate_id>(i % 3));
+	}
+	CHECK(no_dots != opaque);
+
+	auto sizes = table.sizes();
+	REQUIRE(sizes.size() == table.size());
+	for (std::size_t i = 0; i < table.size(); ++i) {
+		CHECK(sizes[i] == table[i].size());
+	}
+
+	auto key = static_cast<std::string>(table[41]);
+	auto matches = table.find_equal(key);
+	CHECK(std::ranges::find(matches, std::size_t{41}) != matches.end());
+	for (std::size_t i = 0; i < table.size(); ++i) {
+		auto expected = static_cast<std::string>(table[i]) == key;
+		CHECK((std::ranges::find(matches, i) != matches.end()) == expected);
+	}
+	CHECK(table.find_equal("no such row").empty());
+
+	auto order = table.sorted_order();
+	REQUIRE(order.size() == table.size());
+	for (std::size_t k = 1; k < order.size(); ++k) {
+		auto lhs = static_cast<std::string>(table[order[k - 1]]);
+		auto rhs = static_cast<std::string>(table[order[k]]);
+		CHECK(lhs <= rhs);
+		if (lhs == rhs) {
+			CHECK(order[k - 1] < order[k]);
+		}
+	}
+	CHECK(fsv::view_table().sorted_order().empty());
+}